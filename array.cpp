@@ -1,204 +1,130 @@
+#include <chrono>
 #include <iostream>
 #include <fstream>
 #include <string>
-#include <sstream>
+#include <string_view>
 
-using namespace std;
-
-class ArrayInterface {
-public:
-    virtual void push(int value) = 0;
-    virtual void addByIndex(int index, int value) = 0;
-    virtual void deleteByIndex(int index) = 0;
-    virtual void setByIndex(int index, int value) = 0;
-    virtual void getValue(int index) = 0;
-    virtual int length() = 0;
-    virtual void displayArray() = 0;
-    virtual void saveToFile(const string& filename) = 0;
-    virtual void loadFromFile(const string& filename) = 0;
-    virtual void printArray() = 0;  // Добавляем новую функцию
-};
-
-// Реализация массива на основе динамического выделения памяти
-class Array : public ArrayInterface {
-public:
-    Array() : size(0), capacity(10) {
-        array = new int[capacity];  // Изначально выделяем память на 10 элементов
-    }
-
-    ~Array() {
-        delete[] array;  // Освобождаем память
-    }
-
-    // Добавление элемента в конец
-    void push(int value) override {
-        if (size >= capacity) {
-            resize();
-        }
-        array[size++] = value;
-    }
-
-    // Добавление элемента по индексу
-    void addByIndex(int index, int value) override {
-        if (index < 0 || index > size) {
-            cout << "Invalid index!" << endl;
-            return;
-        }
-        if (size >= capacity) {
-            resize();
-        }
-        for (int i = size; i > index; --i) {
-            array[i] = array[i - 1];
-        }
-        array[index] = value;
-        size++;
-    }
-
-    // Удаление элемента по индексу
-    void deleteByIndex(int index) override {
-        if (index < 0 || index >= size) {
-            cout << "Index out of bounds!" << endl;
-            return;
-        }
-        for (int i = index; i < size - 1; ++i) {
-            array[i] = array[i + 1];
-        }
-        size--;
-    }
-
-    // Замена элемента по индексу
-    void setByIndex(int index, int value) override {
-        if (index < 0 || index >= size) {
-            cout << "Index out of bounds!" << endl;
-            return;
-        }
-        array[index] = value;
-    }
-
-    // Получение элемента по индексу
-    void getValue(int index) override {
-        if (index < 0 || index >= size) {
-            cout << "Index out of bounds!" << endl;
-        } else {
-            cout << "Element at index " << index << ": " << array[index] << endl;
-        }
-    }
-
-    // Получение длины массива
-    int length() override {
-        return size;
-    }
-
-    // Печать всех элементов массива
-    void displayArray() override {
-        for (int i = 0; i < size; ++i) {
-            cout << array[i] << " ";
-        }
-        cout << endl;
-    }
-
-    // Сохранение массива в файл
-    void saveToFile(const string& filename) override {
-        ofstream outFile(filename);
-        if (outFile.is_open()) {
-            for (int i = 0; i < size; ++i) {
-                outFile << array[i] << endl;
-            }
-            outFile.close();
-        } else {
-            cerr << "Unable to open file for writing!" << endl;
-        }
-    }
+#include "array.h"
+#include "batch.h"
+#include "metrics.h"
+#include "output.h"
+#include "parser.h"
+#include "server.h"
 
-    // Загрузка массива из файла
-    void loadFromFile(const string& filename) override {
-        ifstream inFile(filename);
-        if (inFile.is_open()) {
-            int value;
-            size = 0;  // Сбрасываем текущий размер
-            while (inFile >> value) {
-                push(value);
-            }
-            inFile.close();
-        } else {
-            cerr << "Unable to open file for reading!" << endl;
-        }
-    }
-
-    // Вывод всех элементов массива
-    void printArray() override {
-        displayArray();
-    }
-
-private:
-    int* array;    // Указатель на массив
-    int size;      // Текущий размер массива
-    int capacity;  // Емкость массива
-
-    // Увеличение размера массива в 2 раза
-    void resize() {
-        capacity *= 2;
-        int* newArray = new int[capacity];
-        for (int i = 0; i < size; ++i) {
-            newArray[i] = array[i];
-        }
-        delete[] array;  // Освобождаем старую память
-        array = newArray;
-    }
-};
+using namespace std;
 
 // Обработка команд
-void processCommand(ArrayInterface& array, const string& command) {
-    string cmd;
-    int index, value;
-    istringstream iss(command);
-    iss >> cmd;
+bool executeCommand(Array<int64_t>& array, string_view command, Output& out) {
+    Tokenizer tokens(command);
+    string_view cmd = tokens.next();
+    int index = 0;
+    int64_t value = 0;
 
     if (cmd == "MPUSH") {
-        iss >> value;
+        tokens.nextNumber(value);
         array.push(value);
-        cout << "Added " << value << " to array" << endl;
+        out.done("Added ", value, " to array");
     } else if (cmd == "MADD") {
-        iss >> index >> value;
-        array.addByIndex(index, value);
+        tokens.nextInt(index);
+        tokens.nextNumber(value);
+        if (array.insert(index, value)) {
+            out.done();
+        } else {
+            out.error("Invalid index!");
+        }
     } else if (cmd == "MDEL") {
-        iss >> index;
-        array.deleteByIndex(index);
+        tokens.nextInt(index);
+        if (array.remove(index)) {
+            out.done();
+        } else {
+            out.error("Index out of bounds!");
+        }
     } else if (cmd == "MGET") {
-        iss >> index;
-        array.getValue(index);
+        tokens.nextInt(index);
+        if (array.get(index, value)) {
+            out.value(value, "Element at index ", index, ": ", value);
+        } else {
+            out.error("Index out of bounds!");
+        }
     } else if (cmd == "MSET") {
-        iss >> index >> value;
-        array.setByIndex(index, value);
+        tokens.nextInt(index);
+        tokens.nextNumber(value);
+        if (array.set(index, value)) {
+            out.done();
+        } else {
+            out.error("Index out of bounds!");
+        }
     } else if (cmd == "MLEN") {
-        cout << "Length of array: " << array.length() << endl;
+        out.value(array.length(), "Length of array: ", array.length());
     } else if (cmd == "MPRINT") {
-        array.printArray();
+        out.values(array.length(), [&](ostream& stream) { array.printArray(stream); },
+                   [&](auto visit) { array.forEach(visit); });
+    } else if (cmd == "STATS") {
+        out.report([&](ostream& stream) {
+            metrics.report(tokens, {{"elements", "Number of elements", static_cast<double>(array.length())}}, {},
+                           stream);
+        });
     } else {
-        cout << "Unknown command: " << command << endl;
+        out.error("Unknown command: ", command);
+        return false;
     }
+    return true;
+}
+
+// Выполнение команды с учетом в метриках
+bool processCommand(Array<int64_t>& array, string_view command, Output& out) {
+    return measureCommand(command, [&]() { return executeCommand(array, command, out); });
 }
 
 int main(int argc, char* argv[]) {
+    OutputFormat format = OutputFormat::Text;
+    if (!takeOutputFlags(argc, argv, format)) {
+        cerr << "Invalid output format!" << endl;
+        return 1;
+    }
+    SnapshotFormat snapshotFormat = SnapshotFormat::Text;
+    takeSnapshotFlags(argc, argv, snapshotFormat);  // --compress: файл данных в сжатом формате
     if (argc != 5) {
-        cerr << "Usage: " << argv[0] << " --file filename --query 'COMMAND'" << endl;
+        cerr << "Usage: " << argv[0] << " --file filename --query 'COMMAND' | --batch file | --replay file | --serve address [--compress] [--quiet | --output text|json|binary]" << endl;
         return 1;
     }
 
     string fileFlag = argv[1];
     string filename = argv[2];
-    string queryFlag = argv[3];
-    string query = argv[4];
+    string modeFlag = argv[3];
+    string argument = argv[4];  // Команда, файл с командами или адрес сервера
 
-    if (fileFlag != "--file" || queryFlag != "--query") {
+    if (fileFlag != "--file" || (modeFlag != "--query" && modeFlag != "--batch" && modeFlag != "--replay" && modeFlag != "--serve")) {
         cerr << "Invalid flags!" << endl;
         return 1;
     }
 
-    Array array;
+    Array<int64_t> array;
+    auto start = chrono::steady_clock::now();
     array.loadFromFile(filename);
-    processCommand(array, query);
-    array.saveToFile(filename);
+    metrics.recordLoad(Metrics::since(start));
+    auto handle = [&array, format](string_view command, ostream& stream) {
+        Output out(stream, format);
+        return processCommand(array, command, out);
+    };
+    auto save = [&array, &filename, snapshotFormat]() {
+        auto start = chrono::steady_clock::now();
+        array.saveToFile(filename, snapshotFormat);
+        metrics.recordSave(Metrics::since(start));
+    };
+    if (modeFlag == "--serve") {
+        return server::runServer(argument, handle, save, format);
+    }
+    if (modeFlag == "--batch" || modeFlag == "--replay") {
+        bool done = modeFlag == "--batch" ? batch::runBatch(argument, handle) : batch::runReplay(argument, handle);
+        if (done && modeFlag == "--batch") {  // Воспроизведение трассы не меняет файл данных
+            save();
+        }
+        return done ? 0 : 1;
+    }
+    Output out(cout, format);
+    processCommand(array, argument, out);
+    save();
 
     return 0;
 }
@@ -0,0 +1,194 @@
+#ifndef ARRAY_H
+#define ARRAY_H
+
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <string_view>
+#include <utility>
+
+#include "snapshot.h"
+#include "traits.h"
+
+using namespace std;
+
+// Интерфейс массива элементов типа T (int32_t, int64_t, double, string - см. traits.h)
+template <typename T>
+class ArrayInterface {
+public:
+    virtual ~ArrayInterface() = default;
+    virtual void push(const T& value) = 0;
+    virtual bool insert(int index, const T& value) = 0;
+    virtual bool remove(int index) = 0;
+    virtual bool set(int index, const T& value) = 0;
+    virtual bool get(int index, T& value) const = 0;
+    virtual void addByIndex(int index, const T& value, ostream& out = cout) = 0;
+    virtual void deleteByIndex(int index, ostream& out = cout) = 0;
+    virtual void setByIndex(int index, const T& value, ostream& out = cout) = 0;
+    virtual void getValue(int index, ostream& out = cout) = 0;
+    virtual int length() = 0;
+    virtual void displayArray(ostream& out = cout) = 0;
+    virtual void saveToFile(const string& filename, SnapshotFormat format = SnapshotFormat::Text) = 0;
+    virtual void loadFromFile(const string& filename) = 0;
+    virtual void printArray(ostream& out = cout) = 0;  // Добавляем новую функцию
+};
+
+// Реализация массива на основе динамического выделения памяти
+template <typename T>
+class Array final : public ArrayInterface<T> {
+public:
+    Array() : size(0), capacity(10) {
+        array = new T[capacity];  // Изначально выделяем память на 10 элементов
+    }
+
+    ~Array() override {
+        delete[] array;  // Освобождаем память
+    }
+
+    Array(const Array&) = delete;
+    Array& operator=(const Array&) = delete;
+
+    // Добавление элемента в конец
+    void push(const T& value) override {
+        if (size >= capacity) {
+            resize();
+        }
+        array[size++] = value;
+    }
+
+    // Вставка элемента по индексу без вывода; false, если индекс вне массива
+    bool insert(int index, const T& value) override {
+        if (index < 0 || index > size) {
+            return false;
+        }
+        if (size >= capacity) {
+            resize();
+        }
+        for (int i = size; i > index; --i) {
+            array[i] = std::move(array[i - 1]);
+        }
+        array[index] = value;
+        size++;
+        return true;
+    }
+
+    // Удаление элемента по индексу без вывода; false, если индекс вне массива
+    bool remove(int index) override {
+        if (index < 0 || index >= size) {
+            return false;
+        }
+        for (int i = index; i < size - 1; ++i) {
+            array[i] = std::move(array[i + 1]);
+        }
+        size--;
+        return true;
+    }
+
+    // Замена элемента по индексу без вывода; false, если индекс вне массива
+    bool set(int index, const T& value) override {
+        if (index < 0 || index >= size) {
+            return false;
+        }
+        array[index] = value;
+        return true;
+    }
+
+    // Получение элемента по индексу без вывода; false, если индекс вне массива
+    bool get(int index, T& value) const override {
+        if (index < 0 || index >= size) {
+            return false;
+        }
+        value = array[index];
+        return true;
+    }
+
+    // Добавление элемента по индексу
+    void addByIndex(int index, const T& value, ostream& out = cout) override {
+        if (!insert(index, value)) {
+            out << "Invalid index!" << '\n';
+        }
+    }
+
+    // Удаление элемента по индексу
+    void deleteByIndex(int index, ostream& out = cout) override {
+        if (!remove(index)) {
+            out << "Index out of bounds!" << '\n';
+        }
+    }
+
+    // Замена элемента по индексу
+    void setByIndex(int index, const T& value, ostream& out = cout) override {
+        if (!set(index, value)) {
+            out << "Index out of bounds!" << '\n';
+        }
+    }
+
+    // Получение элемента по индексу
+    void getValue(int index, ostream& out = cout) override {
+        T value;
+        if (!get(index, value)) {
+            out << "Index out of bounds!" << '\n';
+        } else {
+            out << "Element at index " << index << ": " << printed<T>(value) << '\n';
+        }
+    }
+
+    // Получение длины массива
+    int length() override {
+        return size;
+    }
+
+    // Обход элементов по порядку
+    template <typename F>
+    void forEach(F visit) const {
+        for (int i = 0; i < size; ++i) {
+            visit(array[i]);
+        }
+    }
+
+    // Печать всех элементов массива
+    void displayArray(ostream& out = cout) override {
+        for (int i = 0; i < size; ++i) {
+            out << printed<T>(array[i]) << " ";
+        }
+        out << '\n';
+    }
+
+    // Сохранение массива в файл (текстом или в сжатом формате, см. snapshot.h)
+    void saveToFile(const string& filename, SnapshotFormat format = SnapshotFormat::Text) override {
+        if (!snapshot::save<T>(filename, format, [&](auto put) { forEach(put); })) {
+            cerr << "Unable to open file for writing!" << endl;
+        }
+    }
+
+    // Загрузка массива из файла любого формата
+    void loadFromFile(const string& filename) override {
+        size = 0;  // Сбрасываем текущий размер
+        if (!snapshot::load<T>(filename, [&](const T& value) { push(value); })) {
+            cerr << "Unable to open file for reading!" << endl;
+        }
+    }
+
+    // Вывод всех элементов массива
+    void printArray(ostream& out = cout) override {
+        displayArray(out);
+    }
+
+private:
+    T* array;      // Указатель на массив
+    int size;      // Текущий размер массива
+    int capacity;  // Емкость массива
+
+    // Увеличение размера массива в 2 раза
+    void resize() {
+        capacity *= 2;
+        T* newArray = new T[capacity];
+        for (int i = 0; i < size; ++i) {
+            newArray[i] = std::move(array[i]);
+        }
+        delete[] array;  // Освобождаем старую память
+        array = newArray;
+    }
+};
+
+#endif
@@ -0,0 +1,148 @@
+#ifndef BATCH_H
+#define BATCH_H
+
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "histogram.h"
+#include "parser.h"
+
+// Пакетный режим (--batch) и воспроизведение трасс (--replay).
+// Файл содержит по одной команде в синтаксисе --query на строку; "-" - стандартный ввод.
+// --batch выполняет команды и печатает их ответы, --replay выполняет их без вывода
+// и печатает пропускную способность и перцентили задержек по каждой команде.
+
+namespace batch {
+
+// Статистика одной команды трассы (HGET, QPUSH, ...)
+struct CommandStats {
+    std::string name;
+    LatencyHistogram latency;
+};
+
+inline bool readAll(const std::string& filename, std::string& text) {
+    if (filename == "-") {
+        std::ostringstream buffer;
+        buffer << std::cin.rdbuf();
+        text = buffer.str();
+        return true;
+    }
+    std::ifstream inFile(filename, std::ios::binary);
+    if (!inFile.is_open()) {
+        std::cerr << "Unable to open file for reading!" << std::endl;
+        return false;
+    }
+    std::ostringstream buffer;
+    buffer << inFile.rdbuf();
+    text = buffer.str();
+    return true;
+}
+
+// Вызов fn для каждой непустой строки текста
+template <typename F>
+void forEachLine(std::string_view text, F fn) {
+    while (!text.empty()) {
+        size_t end = text.find('\n');
+        std::string_view line = text.substr(0, end);
+        if (!line.empty() && line.back() == '\r') {
+            line.remove_suffix(1);
+        }
+        if (!Tokenizer(line).empty()) {
+            fn(line);
+        }
+        if (end == std::string_view::npos) break;
+        text.remove_prefix(end + 1);
+    }
+}
+
+inline void printLatency(const std::string& name, const LatencyHistogram& h) {
+    std::printf("%-10s %10llu %10.0f %10llu %10llu %10llu %10llu %10llu %10llu\n", name.c_str(),
+                static_cast<unsigned long long>(h.count()), h.mean(),
+                static_cast<unsigned long long>(h.percentile(50)),
+                static_cast<unsigned long long>(h.percentile(90)),
+                static_cast<unsigned long long>(h.percentile(99)),
+                static_cast<unsigned long long>(h.percentile(99.9)),
+                static_cast<unsigned long long>(h.percentile(99.99)),
+                static_cast<unsigned long long>(h.max()));
+}
+
+// Выполнение всех команд файла. handle(command, out) - как в сетевом режиме.
+// Возвращает false, если файл не удалось прочитать
+template <typename Handler>
+bool runBatch(const std::string& filename, Handler handle) {
+    std::string text;
+    if (!readAll(filename, text)) {
+        return false;
+    }
+    // Ответы копятся в большом буфере и сбрасываются только при его заполнении и в конце
+    static char buffer[1 << 16];
+    std::setvbuf(stdout, buffer, _IOFBF, sizeof(buffer));
+    forEachLine(text, [&](std::string_view line) { handle(line, std::cout); });
+    std::cout.flush();
+    return true;
+}
+
+// Воспроизведение трассы в памяти с замером задержки каждой команды (ответы отбрасываются)
+template <typename Handler>
+bool runReplay(const std::string& filename, Handler handle) {
+    std::string text;
+    if (!readAll(filename, text)) {
+        return false;
+    }
+    std::vector<std::string_view> lines;
+    forEachLine(text, [&](std::string_view line) { lines.push_back(line); });
+
+    std::ostream discard(nullptr);  // Форматирование ответов пропускается
+    std::vector<CommandStats*> stats;
+    LatencyHistogram overall;
+    long unknown = 0;
+
+    auto start = std::chrono::steady_clock::now();
+    for (std::string_view line : lines) {
+        auto before = std::chrono::steady_clock::now();
+        bool known = handle(line, discard);
+        auto after = std::chrono::steady_clock::now();
+        uint64_t nanos = static_cast<uint64_t>(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(after - before).count());
+
+        std::string_view name = Tokenizer(line).next();
+        CommandStats* entry = nullptr;
+        for (CommandStats* candidate : stats) {  // Различных команд в трассе единицы
+            if (candidate->name == name) {
+                entry = candidate;
+                break;
+            }
+        }
+        if (entry == nullptr) {
+            entry = new CommandStats();
+            entry->name.assign(name);
+            stats.push_back(entry);
+        }
+        entry->latency.record(nanos);
+        overall.record(nanos);
+        if (!known) unknown++;
+    }
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+    std::printf("Commands: %zu, unknown: %ld\n", lines.size(), unknown);
+    std::printf("Elapsed: %.3f s, throughput: %.0f ops/sec\n", elapsed.count(),
+                elapsed.count() > 0 ? lines.size() / elapsed.count() : 0.0);
+    std::printf("Latency, ns:\n%-10s %10s %10s %10s %10s %10s %10s %10s %10s\n", "command", "count", "mean",
+                "p50", "p90", "p99", "p99.9", "p99.99", "max");
+    for (CommandStats* entry : stats) {
+        printLatency(entry->name, entry->latency);
+        delete entry;
+    }
+    printLatency("ALL", overall);
+    return true;
+}
+
+}  // namespace batch
+
+#endif
@@ -0,0 +1,142 @@
+// Бенчмарк кучи очереди с приоритетом (--priority): DaryHeap с разной арностью
+// против std::priority_queue на заданиях PriorityEntry.
+// Сборка: g++ -std=c++17 -O2 bench/heap_bench.cpp -o heap_bench
+//
+// Запуск: ./heap_bench [--size N] [--format csv|json]   (по умолчанию N = 1e7)
+// Операции: push - N добавлений со случайным приоритетом, pop - извлечение всех,
+// hold - N пар pop + push на заполненной куче (установившийся режим диспетчера).
+// Вывод: одна строка на измерение с полями heap, operation, size, ops, ops_per_sec, ns_per_op.
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <iostream>
+#include <queue>
+#include <string>
+#include <vector>
+
+#include "../heap.h"
+#include "../queue.h"
+
+using namespace std;
+
+namespace {
+
+using Entry = PriorityEntry<int64_t>;
+
+string format = "csv";
+long checksum = 0;  // Не дает компилятору выбросить результаты
+
+// Генератор приоритетов (xorshift64)
+struct Random {
+    uint64_t state = 88172645463325252ULL;
+
+    int64_t next() {
+        state ^= state << 13;
+        state ^= state >> 7;
+        state ^= state << 17;
+        return static_cast<int64_t>(state % 1000000);
+    }
+};
+
+// std::priority_queue извлекает наибольший по operator<, поэтому сравнение обращено
+struct ReadyAfter {
+    bool operator()(const Entry& a, const Entry& b) const {
+        return ReadyBefore()(b, a);
+    }
+};
+
+// Общий интерфейс для std::priority_queue
+struct StdHeap {
+    priority_queue<Entry, vector<Entry>, ReadyAfter> heap;
+
+    void push(const Entry& entry) {
+        heap.push(entry);
+    }
+
+    Entry pop() {
+        Entry first = heap.top();
+        heap.pop();
+        return first;
+    }
+};
+
+template <typename F>
+double measure(F body) {
+    auto start = chrono::steady_clock::now();
+    body();
+    chrono::duration<double> elapsed = chrono::steady_clock::now() - start;
+    return elapsed.count();
+}
+
+void report(const string& heap, const string& operation, long size, long ops, double seconds) {
+    double opsPerSec = seconds > 0 ? ops / seconds : 0;
+    double nsPerOp = ops > 0 ? seconds * 1e9 / ops : 0;
+    if (format == "json") {
+        printf("{\"heap\":\"%s\",\"operation\":\"%s\",\"size\":%ld,\"ops\":%ld,"
+               "\"ops_per_sec\":%.0f,\"ns_per_op\":%.2f}\n",
+               heap.c_str(), operation.c_str(), size, ops, opsPerSec, nsPerOp);
+    } else {
+        printf("%s,%s,%ld,%ld,%.0f,%.2f\n", heap.c_str(), operation.c_str(), size, ops, opsPerSec, nsPerOp);
+    }
+    fflush(stdout);
+}
+
+template <typename Heap>
+void benchHeap(const string& name, long size) {
+    Random random;
+    uint64_t seq = 0;
+    Heap* heap = new Heap();
+    double pushTime = measure([&]() {
+        for (long i = 0; i < size; ++i) heap->push(Entry{random.next(), 0, seq++, i});
+    });
+    report(name, "push", size, size, pushTime);
+
+    double holdTime = measure([&]() {
+        for (long i = 0; i < size; ++i) {
+            Entry entry = heap->pop();
+            checksum += entry.value;
+            entry.priority = random.next();
+            entry.seq = seq++;
+            heap->push(entry);
+        }
+    });
+    report(name, "hold", size, size, holdTime);
+
+    double popTime = measure([&]() {
+        for (long i = 0; i < size; ++i) checksum += heap->pop().value;
+    });
+    report(name, "pop", size, size, popTime);
+    delete heap;
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+    long size = 10000000;
+    for (int i = 1; i + 1 < argc; i += 2) {
+        string flag = argv[i];
+        if (flag == "--size") {
+            size = static_cast<long>(stod(argv[i + 1]));
+        } else if (flag == "--format") {
+            format = argv[i + 1];
+        } else {
+            cerr << "Usage: " << argv[0] << " [--size N] [--format csv|json]" << endl;
+            return 1;
+        }
+    }
+    if (size < 1 || (format != "csv" && format != "json")) {
+        cerr << "Invalid arguments!" << endl;
+        return 1;
+    }
+
+    if (format == "csv") {
+        printf("heap,operation,size,ops,ops_per_sec,ns_per_op\n");
+    }
+    benchHeap<StdHeap>("std_priority_queue", size);
+    benchHeap<DaryHeap<Entry, ReadyBefore, 2>>("dary2", size);
+    benchHeap<DaryHeap<Entry, ReadyBefore, 4>>("dary4", size);
+    benchHeap<DaryHeap<Entry, ReadyBefore, 8>>("dary8", size);
+    cerr << "checksum " << checksum << endl;
+    return 0;
+}
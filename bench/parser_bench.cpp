@@ -0,0 +1,73 @@
+// Микробенчмарк разбора команд: istringstream (старый способ) против Tokenizer.
+// Сборка: g++ -std=c++17 -O2 bench/parser_bench.cpp -o parser_bench
+
+#include <chrono>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <string_view>
+
+#include "../parser.h"
+
+using namespace std;
+
+// Набор запросов всех пяти утилит
+static const string commands[] = {
+    "HSET mykey1 value1", "HGET mykey1", "HDEL mykey1",
+    "LPUSH 5", "RPUSH 42", "LGET 10",
+    "QPUSH 10", "QPOP",
+    "SPUSH 20", "SPOP",
+    "MPUSH 15", "MADD 1 20", "MSET 1 30", "MGET 1",
+};
+
+// Разбор так, как это делал processCommand до Tokenizer
+static long parseWithStream(const string& command) {
+    string cmd, key, value;
+    int a = 0, b = 0;
+    istringstream iss(command);
+    iss >> cmd;
+    if (cmd[0] == 'H') {
+        iss >> key >> value;
+        return static_cast<long>(key.size() + value.size());
+    }
+    iss >> a >> b;
+    return a + b;
+}
+
+static long parseWithTokenizer(string_view command) {
+    Tokenizer tokens(command);
+    string_view cmd = tokens.next();
+    int a = 0, b = 0;
+    if (cmd[0] == 'H') {
+        string_view key = tokens.next();
+        string_view value = tokens.next();
+        return static_cast<long>(key.size() + value.size());
+    }
+    tokens.nextInt(a);
+    tokens.nextInt(b);
+    return a + b;
+}
+
+template <typename Parse>
+static double measure(Parse parse, long iterations, long& checksum) {
+    const size_t count = sizeof(commands) / sizeof(commands[0]);
+    auto start = chrono::steady_clock::now();
+    for (long i = 0; i < iterations; ++i) {
+        checksum += parse(commands[i % count]);
+    }
+    chrono::duration<double> elapsed = chrono::steady_clock::now() - start;
+    return iterations / elapsed.count();
+}
+
+int main(int argc, char* argv[]) {
+    long iterations = argc > 1 ? stol(argv[1]) : 5000000;
+    long checksum = 0;  // Не дает компилятору выбросить разбор
+
+    double before = measure(parseWithStream, iterations, checksum);
+    double after = measure(parseWithTokenizer, iterations, checksum);
+
+    cout << "istringstream: " << static_cast<long>(before) << " commands/sec" << endl;
+    cout << "Tokenizer:     " << static_cast<long>(after) << " commands/sec" << endl;
+    cout << "Speedup:       " << after / before << "x (checksum " << checksum << ")" << endl;
+    return 0;
+}
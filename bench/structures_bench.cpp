@@ -0,0 +1,353 @@
+// Бенчмарк всех пяти структур: вставка, чтение, изменение, удаление, сохранение и загрузка.
+// Сборка: g++ -std=c++17 -O2 bench/structures_bench.cpp -o structures_bench
+//
+// Запуск: ./structures_bench [--min-size N] [--max-size N] [--format csv|json] [--only name]
+// Размеры перебираются степенями 10 от min-size до max-size (по умолчанию 1e3..1e6;
+// 1e8 требует десятков гигабайт памяти для списочных структур).
+//
+// Вывод: одна строка на измерение (CSV с заголовком или JSON Lines) с полями
+// structure, operation, size, ops, ops_per_sec, ns_per_op, bytes_per_element.
+// bytes_per_element - прирост кучи на элемент для построения структуры (push/set)
+// и размер файла на элемент для save/load; для остальных операций 0.
+// Операции с линейной стоимостью (поиск в списке, вставка в хвост односвязного списка)
+// выполняются ограниченное число раз, чтобы прогон на больших размерах не длился часами.
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <string_view>
+
+#include <malloc.h>
+
+#include "../array.h"
+#include "../hash.h"
+#include "../list.h"
+#include "../queue.h"
+#include "../stack.h"
+
+using namespace std;
+
+namespace {
+
+string format = "csv";
+string only;                         // Фильтр по имени структуры
+const long linearBudget = 20000000;  // Суммарное число шагов для операций O(n)
+long checksum = 0;                   // Не дает компилятору выбросить результаты
+
+// Генератор псевдослучайных индексов (xorshift64)
+struct Random {
+    uint64_t state = 88172645463325252ULL;
+
+    long next(long bound) {
+        state ^= state << 13;
+        state ^= state >> 7;
+        state ^= state << 17;
+        return static_cast<long>(state % static_cast<uint64_t>(bound));
+    }
+};
+
+// Занятая память кучи, включая крупные блоки, выделенные через mmap
+long heapInUse() {
+    struct mallinfo2 info = mallinfo2();
+    return static_cast<long>(info.uordblks + info.hblkhd);
+}
+
+long fileSize(const string& filename) {
+    ifstream file(filename, ios::binary | ios::ate);
+    return file.is_open() ? static_cast<long>(file.tellg()) : 0;
+}
+
+// Число повторов для операции, стоимость которой растет линейно с размером
+long linearOps(long size) {
+    long ops = linearBudget / size;
+    if (ops < 1) ops = 1;
+    return ops < size ? ops : size;
+}
+
+long randomOps(long size) {
+    return size < 1000000 ? size : 1000000;
+}
+
+template <typename F>
+double measure(F body) {
+    auto start = chrono::steady_clock::now();
+    body();
+    chrono::duration<double> elapsed = chrono::steady_clock::now() - start;
+    return elapsed.count();
+}
+
+void report(const string& structure, const string& operation, long size, long ops, double seconds,
+            double bytesPerElement = 0) {
+    double opsPerSec = seconds > 0 ? ops / seconds : 0;
+    double nsPerOp = ops > 0 ? seconds * 1e9 / ops : 0;
+    if (format == "json") {
+        printf("{\"structure\":\"%s\",\"operation\":\"%s\",\"size\":%ld,\"ops\":%ld,"
+               "\"ops_per_sec\":%.0f,\"ns_per_op\":%.2f,\"bytes_per_element\":%.2f}\n",
+               structure.c_str(), operation.c_str(), size, ops, opsPerSec, nsPerOp, bytesPerElement);
+    } else {
+        printf("%s,%s,%ld,%ld,%.0f,%.2f,%.2f\n", structure.c_str(), operation.c_str(), size, ops,
+               opsPerSec, nsPerOp, bytesPerElement);
+    }
+    fflush(stdout);
+}
+
+// Сохранение и загрузка: общая часть для всех структур
+template <typename T>
+void benchPersistence(const string& name, T& filled, long size) {
+    string filename = "bench_" + name + ".data";
+    double saveTime = measure([&]() { filled.saveToFile(filename); });
+    double bytes = static_cast<double>(fileSize(filename)) / size;
+    report(name, "save", size, size, saveTime, bytes);
+
+    T* loaded = new T();
+    double loadTime = measure([&]() { loaded->loadFromFile(filename); });
+    report(name, "load", size, size, loadTime, bytes);
+    delete loaded;
+    remove(filename.c_str());
+}
+
+void benchArray(long size) {
+    Random random;
+    long heapBefore = heapInUse();
+    Array<int>* array = new Array<int>();
+    double pushTime = measure([&]() {
+        for (long i = 0; i < size; ++i) array->push(static_cast<int>(i));
+    });
+    report("array", "push", size, size, pushTime, static_cast<double>(heapInUse() - heapBefore) / size);
+
+    long ops = randomOps(size);
+    double getTime = measure([&]() {
+        int value = 0;
+        for (long i = 0; i < ops; ++i) {
+            array->get(static_cast<int>(random.next(size)), value);
+            checksum += value;
+        }
+    });
+    report("array", "get", size, ops, getTime);
+
+    double setTime = measure([&]() {
+        for (long i = 0; i < ops; ++i) array->setByIndex(static_cast<int>(random.next(size)), static_cast<int>(i));
+    });
+    report("array", "set", size, ops, setTime);
+
+    long middleOps = linearOps(size);
+    double insertTime = measure([&]() {
+        for (long i = 0; i < middleOps; ++i) array->addByIndex(array->length() / 2, static_cast<int>(i));
+    });
+    report("array", "insert_middle", size, middleOps, insertTime);
+
+    double deleteTime = measure([&]() {
+        for (long i = 0; i < middleOps; ++i) array->deleteByIndex(array->length() / 2);
+    });
+    report("array", "delete_middle", size, middleOps, deleteTime);
+
+    benchPersistence("array", *array, size);
+
+    double popTime = measure([&]() {
+        for (long i = 0; i < size; ++i) array->deleteByIndex(array->length() - 1);
+    });
+    report("array", "delete_tail", size, size, popTime);
+    delete array;
+}
+
+template <typename List>
+void benchList(const string& name, long size) {
+    Random random;
+    long heapBefore = heapInUse();
+    List* list = new List();
+    double pushTime = measure([&]() {
+        for (long i = 0; i < size; ++i) list->addToHead(static_cast<int>(i));
+    });
+    report(name, "push_head", size, size, pushTime, static_cast<double>(heapInUse() - heapBefore) / size);
+
+    long ops = linearOps(size);
+    double tailTime = measure([&]() {
+        for (long i = 0; i < ops; ++i) list->addToTail(-1);
+    });
+    report(name, "push_tail", size, ops, tailTime);
+
+    double getTime = measure([&]() {
+        for (long i = 0; i < ops; ++i) checksum += list->contains(static_cast<int>(random.next(size)));
+    });
+    report(name, "get", size, ops, getTime);
+
+    benchPersistence(name, *list, size);
+
+    // Значения добавлялись в голову по возрастанию, поэтому size-1-i всегда в голове
+    double deleteTime = measure([&]() {
+        for (long i = 0; i < size; ++i) list->deleteByValue(static_cast<int>(size - 1 - i));
+    });
+    report(name, "delete_head", size, size, deleteTime);
+    delete list;
+}
+
+void benchQueue(long size) {
+    long heapBefore = heapInUse();
+    Queue<int>* queue = new Queue<int>();
+    double pushTime = measure([&]() {
+        for (long i = 0; i < size; ++i) queue->enqueue(static_cast<int>(i));
+    });
+    report("queue", "push", size, size, pushTime, static_cast<double>(heapInUse() - heapBefore) / size);
+
+    long ops = randomOps(size);
+    double peekTime = measure([&]() {
+        int value = 0;
+        for (long i = 0; i < ops; ++i) {
+            queue->front(value);
+            checksum += value;
+        }
+    });
+    report("queue", "peek", size, ops, peekTime);
+
+    benchPersistence("queue", *queue, size);
+
+    double popTime = measure([&]() {
+        int value = 0;
+        for (long i = 0; i < size; ++i) {
+            queue->pop(value);
+            checksum += value;
+        }
+    });
+    report("queue", "pop", size, size, popTime);
+    delete queue;
+}
+
+void benchStack(long size) {
+    long heapBefore = heapInUse();
+    Stack<int>* stack = new Stack<int>();
+    double pushTime = measure([&]() {
+        for (long i = 0; i < size; ++i) stack->push(static_cast<int>(i));
+    });
+    report("stack", "push", size, size, pushTime, static_cast<double>(heapInUse() - heapBefore) / size);
+
+    long ops = randomOps(size);
+    double peekTime = measure([&]() {
+        int value = 0;
+        for (long i = 0; i < ops; ++i) {
+            stack->peek(value);
+            checksum += value;
+        }
+    });
+    report("stack", "peek", size, ops, peekTime);
+
+    benchPersistence("stack", *stack, size);
+
+    double popTime = measure([&]() {
+        for (long i = 0; i < size; ++i) stack->pop();
+    });
+    report("stack", "pop", size, size, popTime);
+    delete stack;
+}
+
+// Ключи и значения строковой таблицы: key<i> в переиспользуемом буфере
+struct StringKeys {
+    using Table = HashTable<string, string>;
+    char buffer[32];
+
+    string_view key(long index) {
+        int length = snprintf(buffer, sizeof(buffer), "key%ld", index);
+        return string_view(buffer, length);
+    }
+
+    static string_view value(long index) {
+        return index % 2 == 0 ? "value" : "other";
+    }
+};
+
+// Целочисленные 64-битные ключи и значения без преобразования в строки
+struct IntegerKeys {
+    using Table = HashTable<int64_t, int64_t>;
+
+    int64_t key(long index) {
+        return 1000000000000LL + index;
+    }
+
+    static int64_t value(long index) {
+        return index;
+    }
+};
+
+template <typename Keys>
+void benchHashTable(const string& name, long size) {
+    Random random;
+    Keys keys;
+    long heapBefore = heapInUse();
+    auto* table = new typename Keys::Table();
+    double setTime = measure([&]() {
+        for (long i = 0; i < size; ++i) table->insert(keys.key(i), Keys::value(0));
+    });
+    report(name, "set", size, size, setTime, static_cast<double>(heapInUse() - heapBefore) / size);
+
+    long ops = randomOps(size);
+    double getTime = measure([&]() {
+        for (long i = 0; i < ops; ++i) checksum += table->find(keys.key(random.next(size))) != nullptr;
+    });
+    report(name, "get", size, ops, getTime);
+
+    double missTime = measure([&]() {
+        for (long i = 0; i < ops; ++i) checksum += table->find(keys.key(size + random.next(size))) != nullptr;
+    });
+    report(name, "get_miss", size, ops, missTime);
+
+    double updateTime = measure([&]() {
+        for (long i = 0; i < ops; ++i) table->insert(keys.key(random.next(size)), Keys::value(1));
+    });
+    report(name, "update", size, ops, updateTime);
+
+    benchPersistence(name, *table, size);
+
+    double deleteTime = measure([&]() {
+        for (long i = 0; i < size; ++i) table->remove(keys.key(i));
+    });
+    report(name, "delete", size, size, deleteTime);
+    delete table;
+}
+
+// Структура выбрана фильтром --only (имя целиком: hash не включает hash_int64)
+bool selected(const string& name) {
+    return only.empty() || name == only;
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+    long minSize = 1000;
+    long maxSize = 1000000;
+    for (int i = 1; i + 1 < argc; i += 2) {
+        string flag = argv[i];
+        if (flag == "--min-size") {
+            minSize = static_cast<long>(stod(argv[i + 1]));
+        } else if (flag == "--max-size") {
+            maxSize = static_cast<long>(stod(argv[i + 1]));
+        } else if (flag == "--format") {
+            format = argv[i + 1];
+        } else if (flag == "--only") {
+            only = argv[i + 1];
+        } else {
+            cerr << "Usage: " << argv[0] << " [--min-size N] [--max-size N] [--format csv|json] [--only name]" << endl;
+            return 1;
+        }
+    }
+    if (minSize < 1 || maxSize < minSize || (format != "csv" && format != "json")) {
+        cerr << "Invalid arguments!" << endl;
+        return 1;
+    }
+
+    if (format == "csv") {
+        printf("structure,operation,size,ops,ops_per_sec,ns_per_op,bytes_per_element\n");
+    }
+    for (long size = minSize; size <= maxSize; size *= 10) {
+        if (selected("array")) benchArray(size);
+        if (selected("single")) benchList<SinglyLinkedList<int>>("single", size);
+        if (selected("double")) benchList<DoublyLinkedList<int>>("double", size);
+        if (selected("queue")) benchQueue(size);
+        if (selected("stack")) benchStack(size);
+        if (selected("hash")) benchHashTable<StringKeys>("hash", size);
+        if (selected("hash_int64")) benchHashTable<IntegerKeys>("hash_int64", size);
+    }
+    cerr << "checksum " << checksum << endl;
+    return 0;
+}
@@ -0,0 +1,277 @@
+// Генератор трасс команд в синтаксисе --query для воспроизведения через --replay.
+// Сборка: g++ -std=c++17 -O2 bench/workload_gen.cpp -o workload_gen
+//
+// Запуск: ./workload_gen --mix 'HGET:95,HSET:5' [--ops N] [--keys N] [--zipf THETA]
+//                        [--burst N] [--preload N] [--seed N] > trace.txt
+//   --mix      команды и их веса; аргументы подставляются по синтаксису команды
+//   --keys     число различных ключей (HSET/HGET/HDEL) и значений (LGET/LDEL)
+//   --zipf     параметр распределения Ципфа для ключей и индексов, 0 <= THETA < 1 (0 - равномерно)
+//   --burst    средняя длина серии одинаковых команд (QPUSH x40, QPOP x35, ...)
+//   --preload  число команд заполнения в начале трассы (HSET всех ключей, QPUSH, MPUSH, ...)
+
+#include <charconv>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <iostream>
+#include <string>
+#include <system_error>
+#include <vector>
+
+using namespace std;
+
+namespace {
+
+// Вид аргументов команды
+enum class Args { None, Key, KeyValue, Value, Index, IndexValue, Member };
+
+struct CommandSpec {
+    const char* name;
+    Args args;
+    int lengthDelta;  // Как команда меняет длину структуры (для индексов MGET/MSET)
+};
+
+const CommandSpec specs[] = {
+    {"HSET", Args::KeyValue, 0}, {"HGET", Args::Key, 0}, {"HDEL", Args::Key, 0},
+    {"QPUSH", Args::Value, 1}, {"QPOP", Args::None, -1}, {"QPEEK", Args::None, 0},
+    {"SPUSH", Args::Value, 1}, {"SPOP", Args::None, -1}, {"SREAD", Args::None, 0},
+    {"MPUSH", Args::Value, 1}, {"MGET", Args::Index, 0}, {"MSET", Args::IndexValue, 0},
+    {"MDEL", Args::Index, -1}, {"MADD", Args::IndexValue, 1}, {"MLEN", Args::None, 0},
+    {"LPUSH", Args::Member, 0}, {"RPUSH", Args::Member, 0}, {"LGET", Args::Member, 0},
+    {"LDEL", Args::Member, 0},
+};
+
+// Команда заполнения для каждого семейства команд
+const char* preloadFor(const string& name) {
+    switch (name[0]) {
+        case 'H': return "HSET";
+        case 'Q': return "QPUSH";
+        case 'S': return "SPUSH";
+        case 'M': return "MPUSH";
+        default: return "LPUSH";
+    }
+}
+
+struct Random {
+    uint64_t state;
+
+    explicit Random(uint64_t seed) : state(seed * 2654435761ULL + 88172645463325252ULL) {}
+
+    uint64_t next() {
+        state ^= state << 13;
+        state ^= state >> 7;
+        state ^= state << 17;
+        return state;
+    }
+
+    double uniform() {
+        return (next() >> 11) * (1.0 / 9007199254740992.0);
+    }
+};
+
+// Распределение Ципфа на [0, n) по методу Грея и др. (как в YCSB): O(n) на подготовку,
+// O(1) на значение. Ранг 0 - самый частый; ранги перемешиваются, чтобы горячие ключи
+// не шли подряд
+class Zipf {
+public:
+    Zipf(uint64_t count, double skew) : n(count), theta(skew) {
+        if (theta <= 0) return;
+        zetan = zeta(n);
+        double zeta2 = zeta(2);
+        alpha = 1.0 / (1.0 - theta);
+        eta = (1 - pow(2.0 / n, 1 - theta)) / (1 - zeta2 / zetan);
+    }
+
+    uint64_t next(Random& random) const {
+        if (theta <= 0) return random.next() % n;
+        double u = random.uniform();
+        double uz = u * zetan;
+        uint64_t rank;
+        if (uz < 1.0) {
+            rank = 0;
+        } else if (uz < 1.0 + pow(0.5, theta)) {
+            rank = 1;
+        } else {
+            rank = static_cast<uint64_t>(n * pow(eta * u - eta + 1, alpha));
+        }
+        if (rank >= n) rank = n - 1;
+        return (rank * 0x9E3779B97F4A7C15ULL) % n;
+    }
+
+private:
+    double zeta(uint64_t count) const {
+        double sum = 0;
+        for (uint64_t i = 1; i <= count; ++i) {
+            sum += 1.0 / pow(static_cast<double>(i), theta);
+        }
+        return sum;
+    }
+
+    uint64_t n;
+    double theta;
+    double zetan = 0;
+    double alpha = 0;
+    double eta = 0;
+};
+
+// Разбор числа целиком, без исключений; допускается запись вида 1e6
+bool parseNumber(const string& text, double& value) {
+    const char* last = text.data() + text.size();
+    auto result = from_chars(text.data(), last, value);
+    return result.ec == errc() && result.ptr == last;
+}
+
+// Неотрицательное целое (число команд, ключей); допускается запись вида 1e6
+bool parseCount(const string& text, long& value) {
+    double number = 0;
+    if (!parseNumber(text, number) || !(number >= 0 && number <= 1e18) || number != floor(number)) {
+        return false;
+    }
+    value = static_cast<long>(number);
+    return true;
+}
+
+template <typename T>
+bool parseInteger(const string& text, T& value) {
+    const char* last = text.data() + text.size();
+    auto result = from_chars(text.data(), last, value);
+    return result.ec == errc() && result.ptr == last;
+}
+
+struct MixEntry {
+    const CommandSpec* spec;
+    double weight;
+};
+
+const CommandSpec* findSpec(const string& name) {
+    for (const CommandSpec& spec : specs) {
+        if (name == spec.name) return &spec;
+    }
+    return nullptr;
+}
+
+// Разбор строки вида "HGET:95,HSET:5"
+bool parseMix(const string& text, vector<MixEntry>& mix) {
+    size_t pos = 0;
+    while (pos < text.size()) {
+        size_t comma = text.find(',', pos);
+        string item = text.substr(pos, comma == string::npos ? string::npos : comma - pos);
+        size_t colon = item.find(':');
+        const CommandSpec* spec = findSpec(item.substr(0, colon));
+        if (spec == nullptr) {
+            cerr << "Unknown command in mix: " << item << endl;
+            return false;
+        }
+        double weight = 1.0;
+        if (colon != string::npos && (!parseNumber(item.substr(colon + 1), weight) || !(weight >= 0))) {
+            cerr << "Invalid weight in mix: " << item << endl;
+            return false;
+        }
+        mix.push_back({spec, weight});
+        if (comma == string::npos) break;
+        pos = comma + 1;
+    }
+    return !mix.empty();
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+    string mixText;
+    long ops = 1000000;
+    long keys = 100000;
+    double skew = 0.99;
+    long burst = 1;
+    long preload = 0;
+    uint64_t seed = 1;
+    bool valid = argc % 2 == 1;
+    for (int i = 1; valid && i + 1 < argc; i += 2) {
+        string flag = argv[i];
+        string value = argv[i + 1];
+        if (flag == "--mix") {
+            mixText = value;
+        } else if (flag == "--ops") {
+            valid = parseCount(value, ops);
+        } else if (flag == "--keys") {
+            valid = parseCount(value, keys);
+        } else if (flag == "--zipf") {
+            valid = parseNumber(value, skew);
+        } else if (flag == "--burst") {
+            valid = parseInteger(value, burst);
+        } else if (flag == "--preload") {
+            valid = parseCount(value, preload);
+        } else if (flag == "--seed") {
+            valid = parseInteger(value, seed);
+        } else {
+            valid = false;
+        }
+    }
+    // Формула YCSB делит на 1 - theta и определена только при 0 <= theta < 1
+    vector<MixEntry> mix;
+    if (!valid || mixText.empty() || keys < 1 || burst < 1 || !(skew >= 0 && skew < 1) || !parseMix(mixText, mix)) {
+        cerr << "Usage: " << argv[0] << " --mix 'HGET:95,HSET:5' [--ops N] [--keys N] [--zipf THETA]"
+             << " [--burst N] [--preload N] [--seed N]" << endl;
+        return 1;
+    }
+
+    Random random(seed);
+    Zipf keyDistribution(static_cast<uint64_t>(keys), skew);
+    double totalWeight = 0;
+    for (const MixEntry& entry : mix) totalWeight += entry.weight;
+
+    long length = 0;  // Текущая длина массива/очереди/стека по трассе
+    auto emit = [&](const CommandSpec& spec) {
+        char buffer[96];
+        long key = static_cast<long>(keyDistribution.next(random));
+        long value = static_cast<long>(random.next() % 1000000);
+        // Индекс по Ципфу внутри текущей длины; при пустом массиве берется 0
+        long index = length > 0 ? key % length : 0;
+        switch (spec.args) {
+            case Args::None: snprintf(buffer, sizeof(buffer), "%s", spec.name); break;
+            case Args::Key: snprintf(buffer, sizeof(buffer), "%s key%ld", spec.name, key); break;
+            case Args::KeyValue: snprintf(buffer, sizeof(buffer), "%s key%ld value%ld", spec.name, key, value); break;
+            case Args::Value: snprintf(buffer, sizeof(buffer), "%s %ld", spec.name, value); break;
+            case Args::Index: snprintf(buffer, sizeof(buffer), "%s %ld", spec.name, index); break;
+            case Args::IndexValue: snprintf(buffer, sizeof(buffer), "%s %ld %ld", spec.name, index, value); break;
+            case Args::Member: snprintf(buffer, sizeof(buffer), "%s %ld", spec.name, key); break;
+        }
+        length += spec.lengthDelta;
+        if (length < 0) length = 0;
+        puts(buffer);
+    };
+
+    const CommandSpec* fill = findSpec(preloadFor(mix[0].spec->name));
+    for (long i = 0; i < preload; ++i) {
+        if (fill->args == Args::KeyValue || fill->args == Args::Member) {
+            // Каждый ключ по одному разу, затем по кругу
+            char buffer[96];
+            if (fill->args == Args::KeyValue) {
+                snprintf(buffer, sizeof(buffer), "%s key%ld value%ld", fill->name, i % keys, i);
+            } else {
+                snprintf(buffer, sizeof(buffer), "%s %ld", fill->name, i % keys);
+            }
+            puts(buffer);
+        } else {
+            emit(*fill);
+        }
+    }
+
+    long emitted = 0;
+    while (emitted < ops) {
+        double pick = random.uniform() * totalWeight;
+        const CommandSpec* spec = mix.back().spec;
+        for (const MixEntry& entry : mix) {
+            if (pick < entry.weight) {
+                spec = entry.spec;
+                break;
+            }
+            pick -= entry.weight;
+        }
+        // Длина серии равномерна на [1, 2*burst-1], в среднем burst
+        long run = burst > 1 ? 1 + static_cast<long>(random.next() % (2 * burst - 1)) : 1;
+        for (long i = 0; i < run && emitted < ops; ++i, ++emitted) {
+            emit(*spec);
+        }
+    }
+    return 0;
+}
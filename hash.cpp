@@ -1,215 +1,487 @@
+#include <algorithm>
+#include <cctype>
+#include <chrono>
 #include <iostream>
 #include <fstream>
 #include <string>
-#include <sstream>
+#include <string_view>
+#include <utility>
+#include <vector>
 
-using namespace std;
+#include "hash.h"
+#include "batch.h"
+#include "metrics.h"
+#include "output.h"
+#include "parser.h"
+#include "server.h"
+#include "shard.h"
 
-// Структура Node для хранения пары ключ-значение в хеш-таблице
-struct Node {
-    string key;   // Ключ элемента
-    string value; // Значение элемента
-    Node* next;        // Указатель на следующий элемент в цепочке
+using namespace std;
 
-    Node(const string& k, const string& v) : key(k), value(v), next(nullptr) {}
-};
+// Хеш-таблица утилиты: строковые ключи и значения, как в файле данных
+using Table = HashTable<string, string>;
 
-// Класс HashTable для реализации хеш-таблицы
-class HashTable {
-public:
-    HashTable(int size = 10) : capacity(size) {
-        table = new Node*[capacity];  // Выделение памяти для массива указателей
-        for (int i = 0; i < capacity; ++i) {
-            table[i] = nullptr;
-        }
-    }
+// Метрики хеш-таблицы для команды STATS
+void reportStats(const Table& hashTable, Tokenizer& tokens, ostream& out) {
+    uint64_t chains[Table::lengthBuckets];
+    hashTable.chainLengths(chains);
+    metrics.report(tokens,
+                   {{"elements", "Number of keys", static_cast<double>(hashTable.size())},
+                    {"hash_buckets", "Number of hash chains", static_cast<double>(hashTable.buckets())},
+                    {"expiring_keys", "Keys with a TTL", static_cast<double>(hashTable.expiring())},
+                    {"expired_keys", "Keys removed by TTL since start", static_cast<double>(hashTable.expiredTotal())},
+                    {"memory_bytes", "Estimated memory of keys, values and chains", static_cast<double>(hashTable.memoryUsage())},
+                    {"maxmemory_bytes", "Memory limit (0 - unlimited)", static_cast<double>(hashTable.memoryLimitBytes())},
+                    {"evicted_keys", "Keys evicted by the memory limit since start", static_cast<double>(hashTable.evictedTotal())}},
+                   {{"hash_chain_length", "Length of hash chains", chains, Table::lengthBuckets},
+                    {"hash_probe_length", "Keys compared per lookup", hashTable.probeLengths(), Table::lengthBuckets}},
+                   out);
+}
 
-    ~HashTable() {
-        clear();  // Освобождение памяти при удалении
-        delete[] table;
-    }
+// Наибольший TTL в секундах (100 лет): срок в миллисекундах не переполняет int64_t
+const int64_t maxTtlSeconds = 100LL * 365 * 24 * 3600;
 
-    // Добавление или обновление элемента по ключу
-    void hset(const string& key, const string& value) {
-        int index = hashFunction(key);
-        Node* prev = nullptr;
-        Node* current = table[index];
+// Вывод найденных пар в формате HPRINT
+void printPairs(const vector<pair<string_view, string_view>>& found, Output& out) {
+    out.pairs(found.size(),
+              [&](ostream& stream) {
+                  for (const auto& [key, value] : found) {
+                      stream << "[" << key << "] -> " << value << '\n';
+                  }
+              },
+              [&](auto visit) {
+                  for (const auto& [key, value] : found) {
+                      visit(key, value);
+                  }
+              });
+}
 
-        // Поиск ключа в цепочке
-        while (current != nullptr && current->key != key) {
-            prev = current;
-            current = current->next;
+// Вывод пар по возрастанию ключей, начиная с first, пока inRange(key) истинно (HSCAN, HRANGE)
+template <typename InRange>
+void printRange(const Table& hashTable, string_view first, InRange inRange, Output& out) {
+    vector<pair<string_view, string_view>> found;
+    hashTable.forEachFrom(first, [&](string_view key, string_view value) {
+        if (!inRange(key)) {
+            return false;
         }
+        found.emplace_back(key, value);
+        return true;
+    });
+    printPairs(found, out);
+}
 
-        if (current == nullptr) {  // Ключ не найден, создаем новый элемент
-            Node* newNode = new Node(key, value);
-            if (prev == nullptr) {  // Вставляем в начало цепочки
-                table[index] = newNode;
-            } else {                // Добавляем в конец цепочки
-                prev->next = newNode;
-            }
-            cout << "Inserted: [" << key << "] -> " << value << endl;
-        } else {  // Ключ уже существует, обновляем значение
-            current->value = value;
-            cout << "Updated: [" << key << "] -> " << value << endl;
-        }
-    }
+// Обработка команд для хеш-таблицы
+bool executeCommand(Table& hashTable, string_view command, Output& out) {
+    Tokenizer tokens(command);
+    string_view cmd = tokens.next();
+    string_view key, value;
+    int64_t seconds = 0;
 
-    // Получение значения по ключу
-    void hget(const string& key) const {
-        int index = hashFunction(key);
-        Node* current = table[index];
+    hashTable.expireDue();  // Активное истечение: ключи с наступившим сроком, не больше пачки за команду
 
-        // Поиск значения по ключу в цепочке
-        while (current != nullptr) {
-            if (current->key == key) {
-                cout << "Found: [" << key << "] -> " << current->value << endl;
-                return;
+    if (cmd == "HSET") {
+        key = tokens.next();
+        value = tokens.next();
+        if (hashTable.insert(key, value)) {
+            out.done("Inserted: [", key, "] -> ", value);
+        } else {
+            out.done("Updated: [", key, "] -> ", value);
+        }
+    } else if (cmd == "HSETEX") {
+        key = tokens.next();
+        bool valid = tokens.nextNumber(seconds) && seconds > 0 && seconds <= maxTtlSeconds;
+        value = tokens.next();
+        if (!valid) {
+            out.error("Invalid TTL!");
+        } else {
+            bool inserted = hashTable.insert(key, value);
+            hashTable.expire(key, wallClockMillis() + seconds * 1000);
+            if (inserted) {
+                out.done("Inserted: [", key, "] -> ", value, " (TTL ", seconds, " s)");
+            } else {
+                out.done("Updated: [", key, "] -> ", value, " (TTL ", seconds, " s)");
             }
-            current = current->next;
         }
-        cout << "Key [" << key << "] not found!" << endl;
-    }
-
-    // Удаление элемента по ключу
-    void hdel(const string& key) {
-        int index = hashFunction(key);
-        Node* prev = nullptr;
-        Node* current = table[index];
-
-        // Поиск ключа в цепочке
-        while (current != nullptr && current->key != key) {
-            prev = current;
-            current = current->next;
+    } else if (cmd == "HEXPIRE") {
+        key = tokens.next();
+        if (!tokens.nextNumber(seconds) || seconds > maxTtlSeconds) {
+            out.error("Invalid TTL!");
+        } else if (seconds <= 0 ? hashTable.remove(key) : hashTable.expire(key, wallClockMillis() + seconds * 1000)) {
+            out.done("Expiry set: [", key, "] -> ", seconds, " s");
+        } else {
+            out.missing("Key [", key, "] not found!");
         }
-
-        if (current == nullptr) {
-            cout << "Key [" << key << "] not found!" << endl;
-            return;
+    } else if (cmd == "HTTL") {
+        key = tokens.next();
+        int64_t expiresAt = 0;
+        if (!hashTable.expiry(key, expiresAt)) {
+            out.value(-2, "Key [", key, "] not found!");
+        } else if (expiresAt == 0) {
+            out.value(-1, "Key [", key, "] has no TTL");
+        } else {
+            seconds = (expiresAt - wallClockMillis() + 500) / 1000;
+            out.value(seconds, "TTL of [", key, "]: ", seconds, " s");
         }
-
-        if (prev == nullptr) {  // Удаление первого элемента в цепочке
-            table[index] = current->next;
-        } else {                // Удаление элемента в середине или конце цепочки
-            prev->next = current->next;
+    } else if (cmd == "HGET") {
+        key = tokens.next();
+        const string* found = hashTable.find(key);
+        if (found != nullptr) {
+            out.value(*found, "Found: [", key, "] -> ", *found);
+        } else {
+            out.missing("Key [", key, "] not found!");
+        }
+    } else if (cmd == "HMGET") {
+        vector<string_view> keys;
+        while (!tokens.empty()) {
+            keys.push_back(tokens.next());
+        }
+        if (keys.empty()) {
+            out.error("No keys given!");
+        } else {
+            vector<pair<string_view, string_view>> found;  // Отсутствующие ключи не выводятся
+            hashTable.findMany(keys.data(), keys.size(), [&](size_t i, const string* stored) {
+                if (stored != nullptr) {
+                    found.emplace_back(keys[i], *stored);
+                }
+            });
+            printPairs(found, out);
+        }
+    } else if (cmd == "HMSET") {
+        vector<string_view> keys, values;
+        while (!tokens.empty()) {
+            keys.push_back(tokens.next());
+            values.push_back(tokens.next());
+        }
+        if (keys.empty() || values.back().empty()) {
+            out.error("Invalid key-value pairs!");
+        } else {
+            size_t inserted = hashTable.insertMany(keys.data(), values.data(), keys.size());
+            out.value(static_cast<long long>(inserted), "Inserted: ", inserted, ", updated: ", keys.size() - inserted);
+        }
+    } else if (cmd == "HDEL") {
+        key = tokens.next();
+        if (hashTable.remove(key)) {
+            out.done("Deleted: [", key, "]");
+        } else {
+            out.missing("Key [", key, "] not found!");
+        }
+    } else if (cmd == "HSCAN") {
+        string_view prefix = tokens.next();
+        printRange(hashTable, prefix, [&](string_view found) { return found.substr(0, prefix.size()) == prefix; }, out);
+    } else if (cmd == "HRANGE") {
+        string_view first = tokens.next();
+        string_view last = tokens.next();
+        if (last.empty()) {
+            out.error("Invalid range!");
+        } else {
+            printRange(hashTable, first, [&](string_view found) { return found <= last; }, out);
         }
+    } else if (cmd == "HPRINT") {
+        // Пары собираются одним обходом: size() учитывает истекшие, но еще не удаленные
+        // ключи, и число пар в заголовке binary разошлось бы с выведенными
+        vector<pair<string_view, string_view>> found;
+        hashTable.forEach([&](string_view key, string_view value) { found.emplace_back(key, value); });
+        printPairs(found, out);
+    } else if (cmd == "STATS") {
+        out.report([&](ostream& stream) { reportStats(hashTable, tokens, stream); });
+    } else {
+        out.error("Unknown command: ", command);
+        return false;
+    }
+    return true;
+}
+
+// Выполнение команды с учетом в метриках
+bool processCommand(Table& hashTable, string_view command, Output& out) {
+    return measureCommand(command, [&]() { return executeCommand(hashTable, command, out); });
+}
 
-        delete current;  // Освобождение памяти
-        cout << "Deleted: [" << key << "]" << endl;
+// Описание хеш-таблицы для шардированного сервера (см. shard.h)
+struct HashTableShard {
+    static bool execute(Table& hashTable, string_view command, ostream& stream, OutputFormat format) {
+        Output out(stream, format);
+        return processCommand(hashTable, command, out);
     }
 
-    // Очистка всей хеш-таблицы
-    void clear() {
-        for (int i = 0; i < capacity; ++i) {
-            Node* current = table[i];
-            while (current != nullptr) {
-                Node* temp = current;
-                current = current->next;
-                delete temp;
+    // Сборка ответа широковещательной команды из записей binary шардов: пары
+    // объединяются по возрастанию ключей, как при --ordered в одном процессе,
+    // тексты отчетов STATS склеиваются по порядку шардов. Ответ HMGET и HMSET
+    // совпадает с ответом одного процесса: пары в порядке ключей запроса, числа новых
+    // ключей шардов складываются
+    static bool merge(string_view command, const vector<string>& parts, ostream& stream, OutputFormat format) {
+        Output out(stream, format);
+        vector<Record> records;
+        for (const string& part : parts) {
+            size_t pos = 0;
+            Record record;
+            if (!part.empty() && readRecord(part, pos, record)) {
+                records.push_back(move(record));
             }
-            table[i] = nullptr;
         }
-    }
-
-    // Сохранение хеш-таблицы в файл
-    void saveToFile(const string& filename) {
-        ofstream outFile(filename);
-        if (outFile.is_open()) {
-            for (int i = 0; i < capacity; ++i) {
-                Node* current = table[i];
-                while (current != nullptr) {
-                    outFile << current->key << " " << current->value << endl;
-                    current = current->next;
+        for (const Record& record : records) {
+            if (record.tag == 'E') {  // Ошибка разбора одинакова во всех шардах
+                out.error(record.text);
+                return true;
+            }
+        }
+        Tokenizer tokens(command);
+        string_view cmd = tokens.next();
+        if (cmd == "HMSET") {
+            long long inserted = 0;
+            long long keys = 0;
+            for (const Record& record : records) {
+                inserted += record.number;
+            }
+            while (!tokens.empty()) {
+                tokens.next();
+                tokens.next();
+                keys++;
+            }
+            out.value(inserted, "Inserted: ", inserted, ", updated: ", keys - inserted);
+            return true;
+        }
+        if (!records.empty() && records[0].tag == 'K') {
+            out.done();
+            return true;
+        }
+        if (!records.empty() && records[0].tag == 'S') {
+            out.report([&](ostream& report) {
+                for (const Record& record : records) {
+                    report << record.text;
+                }
+            });
+            return true;
+        }
+        vector<pair<string_view, string_view>> found;
+        for (const Record& record : records) {
+            found.insert(found.end(), record.pairs.begin(), record.pairs.end());
+        }
+        sort(found.begin(), found.end());
+        if (cmd == "HMGET") {  // Найденные ключи в порядке запроса, повторы ключа повторяются
+            vector<pair<string_view, string_view>> ordered;
+            while (!tokens.empty()) {
+                string_view key = tokens.next();
+                auto it = lower_bound(found.begin(), found.end(), key,
+                                      [](const pair<string_view, string_view>& entry, string_view wanted) { return entry.first < wanted; });
+                if (it != found.end() && it->first == key) {
+                    ordered.push_back(*it);
                 }
             }
-            outFile.close();
-        } else {
-            cerr << "Unable to open file for writing!" << endl;
+            found.swap(ordered);
         }
+        printPairs(found, out);
+        return true;
     }
 
-    // Загрузка хеш-таблицы из файла
-    void loadFromFile(const string& filename) {
-        ifstream inFile(filename);
-        if (inFile.is_open()) {
-            string key, value;
-            clear();  // Сбрасываем текущую хеш-таблицу перед загрузкой
-            while (inFile >> key >> value) {
-                hset(key, value);
+    // Команды с ключом идут в шард ключа, остальные - во все шарды (HSCAN и HRANGE
+    // упорядочены внутри ответа каждого шарда). HMGET и HMSET делятся между шардами
+    // ключей (split); некорректные уходят в шард 0, который ответит ошибкой
+    static int route(string_view command, int shardCount) {
+        Tokenizer tokens(command);
+        string_view cmd = tokens.next();
+        if (cmd == "HSET" || cmd == "HGET" || cmd == "HDEL" || cmd == "HSETEX" || cmd == "HEXPIRE" || cmd == "HTTL") {
+            return keyShard(tokens.next(), shardCount);
+        }
+        if (cmd == "HMGET" || cmd == "HMSET") {
+            size_t arguments = 0;
+            while (!tokens.empty()) {
+                tokens.next();
+                arguments++;
             }
-            inFile.close();
-        } else {
-            cerr << "Unable to open file for reading!" << endl;
+            bool valid = arguments > 0 && (cmd == "HMGET" || arguments % 2 == 0);
+            return valid ? -2 : 0;
         }
+        return cmd == "HPRINT" || cmd == "HSCAN" || cmd == "HRANGE" || cmd == "STATS" ? -1 : 0;
     }
 
-    // Вывод всех значений хеш-таблицы
-    void hprint() const {
-        for (int i = 0; i < capacity; ++i) {
-            Node* current = table[i];
-            while (current != nullptr) {
-                cout << "[" << current->key << "] -> " << current->value << endl;
-                current = current->next;
+    // Команды шардов для HMGET и HMSET: каждый ключ (с значением) - в команду своего шарда
+    static void split(string_view command, int shardCount, vector<string>& commands) {
+        Tokenizer tokens(command);
+        string_view cmd = tokens.next();
+        bool withValues = cmd == "HMSET";
+        while (!tokens.empty()) {
+            string_view key = tokens.next();
+            string& part = commands[keyShard(key, shardCount)];
+            if (part.empty()) {
+                part.assign(cmd);
+            }
+            part.append(" ").append(key);
+            if (withValues) {
+                part.append(" ").append(tokens.next());
             }
         }
     }
 
-private:
-    // Хеш-функция для вычисления индекса на основе ключа
-    int hashFunction(const string& key) const {
-        int hash = 0;
-        for (char ch : key) {
-            hash = (hash * 31 + ch) % capacity;
-        }
-        return hash;
+    static void write(const Table& hashTable, ostream& out) {
+        hashTable.writeEntries(out);
+    }
+};
+
+// Загрузка файла с распределением ключей по шардам
+void loadShards(ShardedExecutor<Table, HashTableShard>& executor, const string& filename) {
+    ifstream inFile(filename);
+    if (!inFile.is_open()) {
+        cerr << "Unable to open file for reading!" << endl;
+        return;
     }
+    Table::readEntries(inFile, [&](const string& key, const string& value, int64_t expiresAt) {
+        Table& shard = executor.engine(keyShard(key, executor.shardCount()));
+        shard.insert(key, value);
+        if (expiresAt != 0) {
+            shard.expire(key, expiresAt);
+        }
+    });
+}
 
-    Node** table;  // Массив указателей на Node* (хеш-таблица)
-    int capacity;  // Емкость таблицы
+// Настройки хеш-таблицы из командной строки
+struct TableOptions {
+    bool ordered = false;                          // --ordered: упорядоченный индекс для HSCAN, HRANGE и HPRINT
+    size_t maxMemory = 0;                          // --maxmemory: ограничение памяти, 0 - без ограничения
+    EvictionPolicy policy = EvictionPolicy::Lru;   // --eviction lru|lfu
 };
 
-// Обработка команд для хеш-таблицы
-void processCommand(HashTable& hashTable, const string& command) {
-    string cmd, key, value;
-    istringstream iss(command);
-    iss >> cmd;
+// Размер в байтах с необязательным суффиксом: 1048576, 512k, 512mb, 2g; false, если
+// запись некорректна или размер не помещается в size_t
+bool parseBytes(string_view text, size_t& bytes) {
+    size_t digits = 0;
+    while (digits < text.size() && text[digits] >= '0' && text[digits] <= '9') {
+        digits++;
+    }
+    Tokenizer number(text.substr(0, digits));
+    uint64_t value = 0;
+    if (!number.nextNumber(value)) {
+        return false;
+    }
+    string unit(text.substr(digits));
+    for (char& ch : unit) {  // Суффикс без учета регистра: 2G, 512MB
+        ch = static_cast<char>(tolower(static_cast<unsigned char>(ch)));
+    }
+    int shift = 0;
+    if (unit == "k" || unit == "kb") {
+        shift = 10;
+    } else if (unit == "m" || unit == "mb") {
+        shift = 20;
+    } else if (unit == "g" || unit == "gb") {
+        shift = 30;
+    } else if (!unit.empty()) {
+        return false;
+    }
+    if (value > (UINT64_MAX >> shift) || (value << shift) > SIZE_MAX) {  // Размер не помещается в size_t
+        return false;
+    }
+    bytes = static_cast<size_t>(value << shift);
+    return true;
+}
 
-    if (cmd == "HSET") {
-        iss >> key >> value;
-        hashTable.hset(key, value);
-    } else if (cmd == "HGET") {
-        iss >> key;
-        hashTable.hget(key);
-    } else if (cmd == "HDEL") {
-        iss >> key;
-        hashTable.hdel(key);
-    } else if (cmd == "HPRINT") {
-        hashTable.hprint();
-    } else {
-        cout << "Unknown command: " << command << endl;
+// Разбор и удаление из argv флагов хеш-таблицы; false при некорректном значении
+bool takeTableFlags(int& argc, char* argv[], TableOptions& options) {
+    int kept = 1;
+    for (int i = 1; i < argc; ++i) {
+        string_view flag = argv[i];
+        if (flag == "--ordered") {
+            options.ordered = true;
+        } else if (flag == "--maxmemory" && i + 1 < argc) {
+            if (!parseBytes(argv[++i], options.maxMemory)) {
+                return false;
+            }
+        } else if (flag == "--eviction" && i + 1 < argc) {
+            string_view name = argv[++i];
+            if (name == "lru") {
+                options.policy = EvictionPolicy::Lru;
+            } else if (name == "lfu") {
+                options.policy = EvictionPolicy::Lfu;
+            } else {
+                return false;
+            }
+        } else {
+            argv[kept++] = argv[i];
+        }
+    }
+    argc = kept;
+    return true;
+}
+
+// Применение настроек до загрузки: индекс строится и память ограничивается по мере вставки;
+// в шардированном режиме ограничение делится поровну между шардами
+void configure(Table& hashTable, const TableOptions& options, int shardCount) {
+    if (options.ordered) {
+        hashTable.enableOrderedIndex();
     }
+    hashTable.setMemoryLimit(options.maxMemory / shardCount, options.policy);
 }
 
 int main(int argc, char* argv[]) {
-    if (argc != 5) {
-        cerr << "Usage: " << argv[0] << " --file filename --query 'COMMAND'" << endl;
+    OutputFormat format = OutputFormat::Text;
+    if (!takeOutputFlags(argc, argv, format)) {
+        cerr << "Invalid output format!" << endl;
+        return 1;
+    }
+    TableOptions options;
+    if (!takeTableFlags(argc, argv, options)) {
+        cerr << "Invalid table options!" << endl;
+        return 1;
+    }
+    if (argc != 5 && argc != 7) {
+        cerr << "Usage: " << argv[0] << " --file filename --query 'COMMAND' | --batch file | --replay file | --serve address [--shards N] [--ordered] [--maxmemory bytes[k|mb|g] [--eviction lru|lfu]] [--quiet | --output text|json|binary]" << endl;
         return 1;
     }
 
     string fileFlag = argv[1];
     string filename = argv[2];
-    string queryFlag = argv[3];
-    string query = argv[4];
+    string modeFlag = argv[3];
+    string argument = argv[4];  // Команда, файл с командами или адрес сервера
 
-    if (fileFlag != "--file" || queryFlag != "--query") {
+    if (fileFlag != "--file" || (modeFlag != "--query" && modeFlag != "--batch" && modeFlag != "--replay" && modeFlag != "--serve")) {
         cerr << "Invalid flags!" << endl;
         return 1;
     }
 
-    HashTable hashTable;
+    int shardCount = 1;
+    if (argc == 7) {
+        Tokenizer count(argv[6]);
+        if (modeFlag != "--serve" || string(argv[5]) != "--shards" || !count.nextInt(shardCount) || shardCount < 1) {
+            cerr << "Invalid flags!" << endl;
+            return 1;
+        }
+    }
+
+    if (shardCount > 1) {  // Каждый шард в своем потоке
+        ShardedExecutor<Table, HashTableShard> executor(shardCount, filename, format);
+        for (int i = 0; i < shardCount; ++i) {
+            configure(executor.engine(i), options, shardCount);
+        }
+        loadShards(executor, filename);
+        executor.start();
+        return server::serve(argument, executor);
+    }
+
+    Table hashTable;
+    configure(hashTable, options, 1);
+    auto start = chrono::steady_clock::now();
     hashTable.loadFromFile(filename);  // Загружаем хеш-таблицу из файла
-    processCommand(hashTable, query);  // Обрабатываем команду
-    hashTable.saveToFile(filename);    // Сохраняем изменения в файл
+    metrics.recordLoad(Metrics::since(start));
+    auto handle = [&hashTable, format](string_view command, ostream& stream) {
+        Output out(stream, format);
+        return processCommand(hashTable, command, out);
+    };
+    auto save = [&hashTable, &filename]() {
+        auto start = chrono::steady_clock::now();
+        hashTable.saveToFile(filename);
+        metrics.recordSave(Metrics::since(start));
+    };
+    if (modeFlag == "--serve") {
+        return server::runServer(argument, handle, save, format);
+    }
+    if (modeFlag == "--batch" || modeFlag == "--replay") {
+        bool done = modeFlag == "--batch" ? batch::runBatch(argument, handle) : batch::runReplay(argument, handle);
+        if (done && modeFlag == "--batch") {  // Воспроизведение трассы не меняет файл данных
+            save();
+        }
+        return done ? 0 : 1;
+    }
+    Output out(cout, format);
+    processCommand(hashTable, argument, out);  // Обрабатываем команду
+    save();                                    // Сохраняем изменения в файл
 
     return 0;
 }
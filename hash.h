@@ -0,0 +1,634 @@
+#ifndef HASH_H
+#define HASH_H
+
+#include <algorithm>
+#include <cstdint>
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "ordered.h"
+#include "parser.h"
+#include "timer.h"
+#include "traits.h"
+
+using namespace std;
+
+// Структура HashNode для хранения пары ключ-значение в хеш-таблице
+template <typename K, typename V>
+struct HashNode {
+    K key;           // Ключ элемента
+    V value;         // Значение элемента
+    HashNode* next;  // Указатель на следующий элемент в цепочке
+    int64_t expiresAt = 0;          // Срок истечения в мс (wallClockMillis); 0 - бессрочно
+    HashNode* timerNext = nullptr;  // Поля колеса таймеров (timer.h)
+    HashNode** timerPrev = nullptr;
+    mutable uint8_t hits = 1;       // Счетчик обращений для вытеснения (см. HashTable::evict)
+
+    HashNode(typename ValueTraits<K>::View k, typename ValueTraits<V>::View v) : key(k), value(v), next(nullptr) {}
+};
+
+// Политика вытеснения при ограничении памяти: Lru - CLOCK (обращение взводит бит,
+// стрелка его сбрасывает), Lfu - GCLOCK (обращение увеличивает счетчик, стрелка уменьшает)
+enum class EvictionPolicy { Lru, Lfu };
+
+// Класс HashTable для реализации хеш-таблицы K -> V (типы из traits.h);
+// Hash - функция хеширования ключа, по умолчанию из ValueTraits<K>
+template <typename K, typename V, typename Hash = KeyHash<K>>
+class HashTable {
+public:
+    using KeyView = typename ValueTraits<K>::View;
+    using ValueView = typename ValueTraits<V>::View;
+    using Node = HashNode<K, V>;
+    using Index = OrderedIndex<K, Node>;
+
+    // Число ячеек в распределениях длин цепочек и проверок (последняя - "15 и больше")
+    static const int lengthBuckets = 16;
+
+    // Наибольшее число ключей, удаляемых по сроку за один вызов expireDue
+    static const int expireBatch = 1000;
+
+    // Насыщение счетчика обращений в режиме Lfu
+    static const uint8_t maxHits = 15;
+
+    // На сколько ключей вперед пакетные операции запрашивают память (findMany, insertMany)
+    static const size_t prefetchDistance = 8;
+
+    HashTable(int size = 10)
+        : capacity(size), count(0), probeCounts(), orderedIndex(nullptr), expiredCount(0),
+          nodeBytes(0), memoryLimit(0), policy(EvictionPolicy::Lru), clockHand(0), evictedCount(0) {
+        table = new Node*[capacity];  // Выделение памяти для массива указателей
+        for (int i = 0; i < capacity; ++i) {
+            table[i] = nullptr;
+        }
+    }
+
+    ~HashTable() {
+        clear();  // Освобождение памяти при удалении
+        delete[] table;
+        delete orderedIndex;
+    }
+
+    HashTable(const HashTable&) = delete;
+    HashTable& operator=(const HashTable&) = delete;
+
+    // Добавление или обновление элемента без вывода; true, если ключ новый
+    bool insert(KeyView key, ValueView value) {
+        return insertAt(hashFunction(key), key, value);
+    }
+
+    // Поиск значения по ключу; nullptr, если ключа нет или его срок истек
+    const V* find(KeyView key) const {
+        const Node* node = lookup(key);
+        return node != nullptr ? &node->value : nullptr;
+    }
+
+    // Пакетный поиск: visit(i, value) для каждого keys[i] по порядку, value - nullptr,
+    // если ключа нет. Ячейки и первые узлы цепочек запрашиваются заранее (см. pipelined),
+    // поэтому промахи кэша соседних ключей перекрываются
+    template <typename F>
+    void findMany(const KeyView* keys, size_t n, F visit) const {
+        pipelined(keys, n, [&](size_t i, int index) {
+            const Node* node = lookupAt(index, keys[i]);
+            visit(i, node != nullptr ? &node->value : nullptr);
+        });
+    }
+
+    // Пакетная вставка или обновление пар keys[i] -> values[i] по порядку; число новых ключей
+    size_t insertMany(const KeyView* keys, const ValueView* values, size_t n) {
+        size_t inserted = 0;
+        pipelined(keys, n, [&](size_t i, int index) {
+            if (insertAt(index, keys[i], values[i])) {
+                inserted++;
+            }
+        });
+        return inserted;
+    }
+
+    // Удаление элемента по ключу без вывода; false, если ключа нет
+    bool remove(KeyView key) {
+        int index = hashFunction(key);
+        Node* prev = nullptr;
+        Node* current = table[index];
+
+        // Поиск ключа в цепочке
+        int probes = 0;
+        while (current != nullptr && current->key != key) {
+            prev = current;
+            current = current->next;
+            probes++;
+        }
+        recordProbes(current != nullptr ? probes + 1 : probes);
+
+        if (current == nullptr) {
+            return false;
+        }
+        bool found = !expired(current);  // Истекший ключ удаляется, но считается отсутствующим
+        unlink(index, prev, current);
+        return found;
+    }
+
+    // Установка срока истечения ключа (мс, wallClockMillis); false, если ключа нет
+    bool expire(KeyView key, int64_t expiresAt) {
+        Node* node = lookup(key);
+        if (node == nullptr) {
+            return false;
+        }
+        timers.cancel(node);
+        node->expiresAt = expiresAt;
+        if (expiresAt != 0) {
+            timers.schedule(node);
+        }
+        return true;
+    }
+
+    // Срок истечения ключа (0 - бессрочно); false, если ключа нет
+    bool expiry(KeyView key, int64_t& expiresAt) const {
+        const Node* node = lookup(key);
+        if (node == nullptr) {
+            return false;
+        }
+        expiresAt = node->expiresAt;
+        return true;
+    }
+
+    // Удаление ключей с наступившим сроком (не больше limit за вызов; остальные
+    // скрыты от поиска и обходов до следующего вызова). Возвращает число удаленных.
+    int expireDue(int limit = expireBatch) {
+        if (timers.size() == 0) {
+            return 0;
+        }
+        int removed = timers.advance(wallClockMillis(), limit, [&](Node* node) { remove(node->key); });
+        expiredCount += removed;
+        return removed;
+    }
+
+    // Число ключей со сроком истечения
+    size_t expiring() const {
+        return timers.size();
+    }
+
+    // Число ключей, удаленных по сроку с момента запуска
+    uint64_t expiredTotal() const {
+        return expiredCount;
+    }
+
+    // Ограничение памяти таблицы в байтах (0 - без ограничения): при превышении
+    // insert вытесняет ключи по политике policy
+    void setMemoryLimit(size_t bytes, EvictionPolicy evictionPolicy) {
+        memoryLimit = bytes;
+        policy = evictionPolicy;
+    }
+
+    size_t memoryLimitBytes() const {
+        return memoryLimit;
+    }
+
+    // Оценка памяти таблицы: узлы с ключами и значениями и массив цепочек
+    // (упорядоченный индекс не учитывается)
+    size_t memoryUsage() const {
+        return nodeBytes + static_cast<size_t>(capacity) * sizeof(Node*);
+    }
+
+    // Число вытесненных ключей с момента запуска
+    uint64_t evictedTotal() const {
+        return evictedCount;
+    }
+
+    // Добавление или обновление элемента по ключу
+    void hset(KeyView key, ValueView value, ostream& out = cout) {
+        if (insert(key, value)) {
+            out << "Inserted: [" << printed<K>(key) << "] -> " << printed<V>(value) << '\n';
+        } else {
+            out << "Updated: [" << printed<K>(key) << "] -> " << printed<V>(value) << '\n';
+        }
+    }
+
+    // Получение значения по ключу
+    void hget(KeyView key, ostream& out = cout) const {
+        const V* value = find(key);
+        if (value != nullptr) {
+            out << "Found: [" << printed<K>(key) << "] -> " << printed<V>(*value) << '\n';
+        } else {
+            out << "Key [" << printed<K>(key) << "] not found!" << '\n';
+        }
+    }
+
+    // Удаление элемента по ключу
+    void hdel(KeyView key, ostream& out = cout) {
+        if (remove(key)) {
+            out << "Deleted: [" << printed<K>(key) << "]" << '\n';
+        } else {
+            out << "Key [" << printed<K>(key) << "] not found!" << '\n';
+        }
+    }
+
+    // Количество элементов
+    int size() const {
+        return count;
+    }
+
+    // Включение упорядоченного индекса ключей (см. ordered.h); дальше он
+    // поддерживается при каждой вставке и удалении
+    void enableOrderedIndex() {
+        if (orderedIndex != nullptr) {
+            return;
+        }
+        orderedIndex = new Index();
+        for (int i = 0; i < capacity; ++i) {
+            for (Node* current = table[i]; current != nullptr; current = current->next) {
+                orderedIndex->insert(current);
+            }
+        }
+    }
+
+    bool ordered() const {
+        return orderedIndex != nullptr;
+    }
+
+    // Обход всех пар: по возрастанию ключей при включенном индексе, иначе в порядке цепочек
+    template <typename F>
+    void forEach(F visit) const {
+        int64_t now = wallClockMillis();
+        if (orderedIndex != nullptr) {
+            orderedIndex->forEach([&](const Node& node) {
+                if (live(&node, now)) visit(node.key, node.value);
+                return true;
+            });
+            return;
+        }
+        for (int i = 0; i < capacity; ++i) {
+            for (Node* current = table[i]; current != nullptr; current = current->next) {
+                if (live(current, now)) visit(current->key, current->value);
+            }
+        }
+    }
+
+    // Обход пар с ключом не меньше first по возрастанию ключей; visit(key, value)
+    // возвращает false, чтобы остановиться. Без индекса подходящие пары сортируются
+    // при каждом вызове.
+    template <typename F>
+    void forEachFrom(KeyView first, F visit) const {
+        int64_t now = wallClockMillis();
+        if (orderedIndex != nullptr) {
+            orderedIndex->forEachFrom(first, [&](const Node& node) { return !live(&node, now) || visit(node.key, node.value); });
+            return;
+        }
+        vector<const Node*> nodes;
+        for (int i = 0; i < capacity; ++i) {
+            for (Node* current = table[i]; current != nullptr; current = current->next) {
+                if (!(current->key < first) && live(current, now)) {
+                    nodes.push_back(current);
+                }
+            }
+        }
+        sort(nodes.begin(), nodes.end(), [](const Node* a, const Node* b) { return a->key < b->key; });
+        for (const Node* node : nodes) {
+            if (!visit(node->key, node->value)) {
+                return;
+            }
+        }
+    }
+
+    // Число цепочек
+    int buckets() const {
+        return capacity;
+    }
+
+    // Распределение длин цепочек: counts[i] - число цепочек длины i
+    void chainLengths(uint64_t (&counts)[lengthBuckets]) const {
+        for (int i = 0; i < lengthBuckets; ++i) {
+            counts[i] = 0;
+        }
+        for (int i = 0; i < capacity; ++i) {
+            int length = 0;
+            for (Node* current = table[i]; current != nullptr; current = current->next) {
+                length++;
+            }
+            counts[length < lengthBuckets ? length : lengthBuckets - 1]++;
+        }
+    }
+
+    // Распределение числа сравненных ключей при поиске, вставке и удалении
+    const uint64_t* probeLengths() const {
+        return probeCounts;
+    }
+
+    // Очистка всей хеш-таблицы
+    void clear() {
+        timers.clear();
+        for (int i = 0; i < capacity; ++i) {
+            Node* current = table[i];
+            while (current != nullptr) {
+                Node* temp = current;
+                current = current->next;
+                delete temp;
+            }
+            table[i] = nullptr;
+        }
+        count = 0;
+        nodeBytes = 0;
+        if (orderedIndex != nullptr) {
+            orderedIndex->clear();
+        }
+    }
+
+    // Запись всех пар в поток (формат файла данных): строка "ключ значение" или
+    // "ключ значение срок" для ключей со сроком истечения; истекшие ключи не пишутся
+    void writeEntries(ostream& outFile) const {
+        int64_t now = wallClockMillis();
+        for (int i = 0; i < capacity; ++i) {
+            Node* current = table[i];
+            while (current != nullptr) {
+                if (current->expiresAt == 0) {
+                    outFile << printed<K>(current->key) << " " << printed<V>(current->value) << "\n";
+                } else if (current->expiresAt > now) {
+                    outFile << printed<K>(current->key) << " " << printed<V>(current->value) << " " << current->expiresAt << "\n";
+                }
+                current = current->next;
+            }
+        }
+    }
+
+    // Чтение записей файла данных; для записей с неистекшим сроком или без срока
+    // вызывается add(key, value, expiresAt). Чтение останавливается на первой
+    // некорректной строке.
+    template <typename F>
+    static void readEntries(istream& inFile, F add) {
+        int64_t now = wallClockMillis();
+        string line;
+        K key;
+        V value;
+        while (getline(inFile, line)) {
+            Tokenizer tokens(line);
+            if (tokens.empty()) {
+                continue;
+            }
+            int64_t expiresAt = 0;
+            if (!ValueTraits<K>::parse(tokens.next(), key) || !ValueTraits<V>::parse(tokens.next(), value) ||
+                (!tokens.empty() && !tokens.nextNumber(expiresAt))) {
+                break;
+            }
+            if (expiresAt == 0 || expiresAt > now) {
+                add(key, value, expiresAt);
+            }
+        }
+    }
+
+    // Сохранение хеш-таблицы в файл
+    void saveToFile(const string& filename) {
+        ofstream outFile(filename);
+        if (outFile.is_open()) {
+            writeEntries(outFile);
+            outFile.close();
+        } else {
+            cerr << "Unable to open file for writing!" << endl;
+        }
+    }
+
+    // Загрузка хеш-таблицы из файла
+    void loadFromFile(const string& filename) {
+        ifstream inFile(filename);
+        if (inFile.is_open()) {
+            clear();  // Сбрасываем текущую хеш-таблицу перед загрузкой
+            readEntries(inFile, [&](const K& key, const V& value, int64_t expiresAt) {
+                insert(key, value);
+                if (expiresAt != 0) {
+                    expire(key, expiresAt);
+                }
+            });
+            inFile.close();
+        } else {
+            cerr << "Unable to open file for reading!" << endl;
+        }
+    }
+
+    // Вывод всех значений хеш-таблицы (по порядку ключей при включенном индексе)
+    void hprint(ostream& out = cout) const {
+        forEach([&](const K& key, const V& value) {
+            out << "[" << printed<K>(key) << "] -> " << printed<V>(value) << '\n';
+        });
+    }
+
+private:
+    // Хеш-функция для вычисления индекса на основе ключа
+    int hashFunction(KeyView key) const {
+        return bucketOf(Hash()(key));
+    }
+
+    int bucketOf(uint64_t hash) const {
+        return static_cast<int>(hash % static_cast<uint64_t>(capacity));
+    }
+
+    // Конвейер пакетных операций: сначала считаются хеши всех ключей, затем на шаге i
+    // запрашивается ячейка ключа i, первый узел цепочки ключа i - prefetchDistance
+    // (его ячейка уже в кэше) и выполняется resolve(j, index) для j = i - 2 * prefetchDistance.
+    // Ячейка берется по текущей емкости, так что resize внутри resolve безопасен,
+    // а запрос памяти по устаревшему адресу ничего не ломает.
+    template <typename Resolve>
+    void pipelined(const KeyView* keys, size_t n, Resolve resolve) const {
+        vector<uint64_t> hashes(n);
+        for (size_t i = 0; i < n; ++i) {
+            hashes[i] = Hash()(keys[i]);
+        }
+        for (size_t i = 0; i < n + 2 * prefetchDistance; ++i) {
+            if (i < n) {
+                __builtin_prefetch(&table[bucketOf(hashes[i])]);
+            }
+            if (i >= prefetchDistance && i - prefetchDistance < n) {
+                __builtin_prefetch(table[bucketOf(hashes[i - prefetchDistance])]);
+            }
+            if (i >= 2 * prefetchDistance) {
+                size_t j = i - 2 * prefetchDistance;
+                resolve(j, bucketOf(hashes[j]));
+            }
+        }
+    }
+
+    // Увеличение числа цепочек в 2 раза с перераспределением узлов
+    void resize() {
+        Node** oldTable = table;
+        int oldCapacity = capacity;
+        capacity *= 2;
+        table = new Node*[capacity];
+        for (int i = 0; i < capacity; ++i) {
+            table[i] = nullptr;
+        }
+        for (int i = 0; i < oldCapacity; ++i) {
+            Node* current = oldTable[i];
+            while (current != nullptr) {
+                Node* next = current->next;
+                int index = hashFunction(current->key);
+                current->next = table[index];
+                table[index] = current;
+                current = next;
+            }
+        }
+        delete[] oldTable;  // Освобождаем старый массив цепочек
+    }
+
+    // Вставка в цепочку index (index - ячейка ключа key)
+    bool insertAt(int index, KeyView key, ValueView value) {
+        Node* prev = nullptr;
+        Node* current = table[index];
+
+        // Поиск ключа в цепочке
+        int probes = 0;
+        while (current != nullptr && current->key != key) {
+            prev = current;
+            current = current->next;
+            probes++;
+        }
+        recordProbes(current != nullptr ? probes + 1 : probes);
+
+        if (current != nullptr) {  // Ключ уже существует, обновляем значение и снимаем срок
+            bool fresh = expired(current);
+            nodeBytes += ValueTraits<V>::heapBytes(value);
+            nodeBytes -= ValueTraits<V>::heapBytes(current->value);
+            current->value = value;
+            timers.cancel(current);
+            current->expiresAt = 0;
+            touch(current);
+            enforceLimit(current);
+            return fresh;
+        }
+
+        Node* newNode = new Node(key, value);
+        if (prev == nullptr) {  // Вставляем в начало цепочки
+            table[index] = newNode;
+        } else {                // Добавляем в конец цепочки
+            prev->next = newNode;
+        }
+        if (orderedIndex != nullptr) {
+            orderedIndex->insert(newNode);
+        }
+        nodeBytes += footprint(newNode);
+        if (++count > capacity) {  // Держим среднюю длину цепочки не больше 1
+            resize();
+        }
+        enforceLimit(newNode);
+        return true;
+    }
+
+    // Исключение узла из цепочки index (prev - предыдущий узел или nullptr) и его удаление
+    void unlink(int index, Node* prev, Node* node) {
+        timers.cancel(node);
+        if (prev == nullptr) {  // Удаление первого элемента в цепочке
+            table[index] = node->next;
+        } else {                // Удаление элемента в середине или конце цепочки
+            prev->next = node->next;
+        }
+        if (orderedIndex != nullptr) {
+            orderedIndex->remove(node->key);
+        }
+        nodeBytes -= footprint(node);
+        delete node;  // Освобождение памяти
+        count--;
+    }
+
+    // Узел с ключом; nullptr, если ключа нет или его срок истек (ленивое истечение:
+    // сам узел удаляется позже, в expireDue)
+    Node* lookup(KeyView key) const {
+        return lookupAt(hashFunction(key), key);
+    }
+
+    Node* lookupAt(int index, KeyView key) const {
+        Node* current = table[index];
+        int probes = 1;
+        while (current != nullptr) {
+            if (current->key == key) {
+                recordProbes(probes);
+                if (expired(current)) {
+                    return nullptr;
+                }
+                touch(current);
+                return current;
+            }
+            current = current->next;
+            probes++;
+        }
+        recordProbes(probes - 1);
+        return nullptr;
+    }
+
+    // Срок узла не истек к моменту now
+    static bool live(const Node* node, int64_t now) {
+        return node->expiresAt == 0 || node->expiresAt > now;
+    }
+
+    // Срок узла уже истек; часы читаются только для узлов со сроком
+    static bool expired(const Node* node) {
+        return node->expiresAt != 0 && node->expiresAt <= wallClockMillis();
+    }
+
+    // Оценка памяти узла: сам узел с заголовком блока кучи и внешние буферы ключа и значения
+    static size_t footprint(const Node* node) {
+        return sizeof(Node) + 16 + ValueTraits<K>::heapBytes(node->key) + ValueTraits<V>::heapBytes(node->value);
+    }
+
+    // Отметка обращения к узлу; без ограничения памяти счетчики не ведутся
+    void touch(const Node* node) const {
+        if (memoryLimit == 0) {
+            return;
+        }
+        if (policy == EvictionPolicy::Lru) {
+            node->hits = 1;
+        } else if (node->hits < maxHits) {
+            node->hits++;
+        }
+    }
+
+    // Вытеснение, пока память превышает ограничение; keep - только что записанный узел
+    void enforceLimit(const Node* keep) {
+        while (memoryLimit != 0 && memoryUsage() > memoryLimit && count > 1 && evict(keep)) {
+            evictedCount++;
+        }
+    }
+
+    // Один ход часовой стрелки по цепочкам: узлы с ненулевым счетчиком теряют единицу
+    // и получают вторую попытку, первый узел с нулевым счетчиком (или истекший)
+    // удаляется. Узлы не переставляются при обращении, так что поиск ничего не пишет,
+    // кроме счетчика. false, если вытеснить нечего (остался только keep).
+    bool evict(const Node* keep) {
+        long long steps = static_cast<long long>(capacity) * (maxHits + 2);  // За столько цепочек счетчики обнулятся
+        for (; steps > 0; --steps) {
+            if (clockHand >= capacity) {
+                clockHand = 0;
+            }
+            Node* prev = nullptr;
+            for (Node* current = table[clockHand]; current != nullptr; prev = current, current = current->next) {
+                if (current == keep) {
+                    continue;
+                }
+                if (current->hits == 0 || expired(current)) {
+                    unlink(clockHand, prev, current);
+                    return true;
+                }
+                current->hits--;
+            }
+            clockHand++;
+        }
+        return false;
+    }
+
+    void recordProbes(int probes) const {
+        probeCounts[probes < lengthBuckets ? probes : lengthBuckets - 1]++;
+    }
+
+    Node** table;  // Массив указателей на Node* (хеш-таблица)
+    int capacity;      // Емкость таблицы (число цепочек)
+    int count;         // Количество элементов
+    mutable uint64_t probeCounts[lengthBuckets];  // Статистика для STATS
+    Index* orderedIndex;  // Упорядоченный индекс ключей; nullptr, если не включен
+    TimerWheel<Node> timers;  // Таймеры ключей со сроком истечения
+    uint64_t expiredCount;    // Удалено по сроку (для STATS)
+    size_t nodeBytes;         // Оценка памяти всех узлов (footprint)
+    size_t memoryLimit;       // Ограничение памяти; 0 - без ограничения
+    EvictionPolicy policy;
+    int clockHand;            // Цепочка, с которой продолжит стрелка вытеснения
+    uint64_t evictedCount;    // Вытеснено (для STATS)
+};
+
+#endif
@@ -0,0 +1,107 @@
+#ifndef HEAP_H
+#define HEAP_H
+
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+// d-арная куча в одном векторе: дети узла i - d*i+1 .. d*i+d. При d = 4 все дети
+// лежат в одной-двух кэш-линиях, а высота вдвое меньше двоичной, поэтому извлечение
+// делает меньше промахов кэша, чем std::priority_queue (d = 2), ценой d-1 сравнений
+// на уровень вместо одного.
+// Before(a, b) - a извлекается раньше b.
+template <typename Entry, typename Before, std::size_t Arity = 4>
+class DaryHeap {
+public:
+    static_assert(Arity >= 2, "heap arity must be at least 2");
+
+    explicit DaryHeap(Before before = Before()) : before(before) {}
+
+    bool empty() const {
+        return entries.empty();
+    }
+
+    std::size_t size() const {
+        return entries.size();
+    }
+
+    // Первый элемент; куча не должна быть пустой
+    const Entry& top() const {
+        return entries.front();
+    }
+
+    void push(Entry entry) {
+        entries.push_back(std::move(entry));
+        siftUp(entries.size() - 1);
+    }
+
+    // Извлечение первого элемента; куча не должна быть пустой
+    Entry pop() {
+        Entry first = std::move(entries.front());
+        if (entries.size() > 1) {
+            entries.front() = std::move(entries.back());
+            entries.pop_back();
+            siftDown(0);
+        } else {
+            entries.pop_back();
+        }
+        return first;
+    }
+
+    void reserve(std::size_t count) {
+        entries.reserve(count);
+    }
+
+    void clear() {
+        entries.clear();
+    }
+
+    // Элементы в порядке хранения (не в порядке извлечения)
+    const std::vector<Entry>& raw() const {
+        return entries;
+    }
+
+private:
+    // Подъем с "дыркой": элемент записывается один раз на свое место
+    void siftUp(std::size_t index) {
+        Entry moving = std::move(entries[index]);
+        while (index > 0) {
+            std::size_t parent = (index - 1) / Arity;
+            if (!before(moving, entries[parent])) {
+                break;
+            }
+            entries[index] = std::move(entries[parent]);
+            index = parent;
+        }
+        entries[index] = std::move(moving);
+    }
+
+    void siftDown(std::size_t index) {
+        std::size_t count = entries.size();
+        Entry moving = std::move(entries[index]);
+        for (;;) {
+            std::size_t first = index * Arity + 1;
+            if (first >= count) {
+                break;
+            }
+            std::size_t last = first + Arity < count ? first + Arity : count;
+            std::size_t best = first;
+            for (std::size_t child = first + 1; child < last; ++child) {
+                if (before(entries[child], entries[best])) {
+                    best = child;
+                }
+            }
+            if (!before(entries[best], moving)) {
+                break;
+            }
+            entries[index] = std::move(entries[best]);
+            index = best;
+        }
+        entries[index] = std::move(moving);
+    }
+
+    std::vector<Entry> entries;
+    Before before;
+};
+
+#endif
@@ -0,0 +1,91 @@
+#ifndef HISTOGRAM_H
+#define HISTOGRAM_H
+
+#include <cstdint>
+#include <cstring>
+
+// Гистограмма задержек в стиле HdrHistogram: значения до 64 хранятся точно,
+// дальше каждая степень двойки делится на 32 корзины (относительная ошибка ~3%).
+// Запись - O(1) без выделения памяти, поэтому годится для горячего пути.
+class LatencyHistogram {
+public:
+    static const int bucketCount = 64 + 58 * 32;
+
+    LatencyHistogram() {
+        reset();
+    }
+
+    void reset() {
+        std::memset(counts, 0, sizeof(counts));
+        total = 0;
+        sum = 0;
+        minimum = UINT64_MAX;
+        maximum = 0;
+    }
+
+    void record(uint64_t value) {
+        counts[bucketOf(value)]++;
+        total++;
+        sum += value;
+        if (value < minimum) minimum = value;
+        if (value > maximum) maximum = value;
+    }
+
+    void merge(const LatencyHistogram& other) {
+        for (int i = 0; i < bucketCount; ++i) {
+            counts[i] += other.counts[i];
+        }
+        total += other.total;
+        sum += other.sum;
+        if (other.minimum < minimum) minimum = other.minimum;
+        if (other.maximum > maximum) maximum = other.maximum;
+    }
+
+    // Значение, не меньше которого percent процентов записей (верхняя граница корзины)
+    uint64_t percentile(double percent) const {
+        if (total == 0) return 0;
+        uint64_t rank = static_cast<uint64_t>(percent / 100.0 * total + 0.5);
+        if (rank < 1) rank = 1;
+        uint64_t seen = 0;
+        for (int i = 0; i < bucketCount; ++i) {
+            seen += counts[i];
+            if (seen >= rank) {
+                uint64_t upper = upperBound(i);
+                return upper < maximum ? upper : maximum;
+            }
+        }
+        return maximum;
+    }
+
+    uint64_t count() const { return total; }
+    uint64_t min() const { return total == 0 ? 0 : minimum; }
+    uint64_t max() const { return maximum; }
+    double mean() const { return total == 0 ? 0 : static_cast<double>(sum) / total; }
+    uint64_t valueSum() const { return sum; }
+
+    // Доступ к корзинам для экспорта (например, в формате Prometheus)
+    uint64_t bucketCountAt(int index) const { return counts[index]; }
+
+    static uint64_t upperBound(int index) {
+        if (index < 64) return static_cast<uint64_t>(index);
+        int shift = index / 32 - 1;
+        uint64_t mantissa = static_cast<uint64_t>(index % 32 + 32);
+        return ((mantissa + 1) << shift) - 1;
+    }
+
+private:
+    static int bucketOf(uint64_t value) {
+        if (value < 64) return static_cast<int>(value);
+        int highBit = 63 - __builtin_clzll(value);
+        int shift = highBit - 5;
+        return shift * 32 + static_cast<int>(value >> shift);
+    }
+
+    uint64_t counts[bucketCount];
+    uint64_t total;
+    uint64_t sum;
+    uint64_t minimum;
+    uint64_t maximum;
+};
+
+#endif
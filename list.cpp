@@ -1,278 +1,111 @@
+#include <chrono>
 #include <iostream>
 #include <fstream>
 #include <string>
-#include <sstream>
+#include <string_view>
 
-using namespace std;
-
-// Узел для двусвязного списка
-struct Node {
-    int data;
-    Node* next;
-    Node* prev;
-
-    Node(int value) : data(value), next(nullptr), prev(nullptr) {}
-};
-
-// Узел для односвязного списка
-struct SingleNode {
-    int data;
-    SingleNode* next;
-
-    SingleNode(int value) : data(value), next(nullptr) {}
-};
-
-// Интерфейс для общих операций списка
-class ListInterface {
-public:
-    virtual void addToHead(int value) = 0;
-    virtual void addToTail(int value) = 0; // Добавляем новую команду
-    virtual void deleteByValue(int value) = 0;
-    virtual void getValue(int value) = 0;
-    virtual void displayList() = 0;
-    virtual void saveToFile(const string& filename) = 0;
-    virtual void loadFromFile(const string& filename) = 0;
-    virtual void printList() = 0;
-};
-
-// Реализация двусвязного списка
-class DoublyLinkedList : public ListInterface {
-public:
-    DoublyLinkedList() : head(nullptr), tail(nullptr) {}
-
-    void addToHead(int value) override {
-        Node* newNode = new Node(value);
-        if (head == nullptr) {
-            head = tail = newNode;
-        } else {
-            newNode->next = head;
-            head->prev = newNode;
-            head = newNode;
-        }
-    }
-
-    void addToTail(int value) override {
-        Node* newNode = new Node(value);
-        if (tail == nullptr) {
-            head = tail = newNode;
-        } else {
-            newNode->prev = tail;
-            tail->next = newNode;
-            tail = newNode;
-        }
-    }
-
-    void deleteByValue(int value) override {
-        Node* current = head;
-        while (current != nullptr && current->data != value) {
-            current = current->next;
-        }
-        if (current == nullptr) return;
-
-        if (current == head) {
-            head = head->next;
-            if (head != nullptr) head->prev = nullptr;
-        } else if (current == tail) {
-            tail = tail->prev;
-            if (tail != nullptr) tail->next = nullptr;
-        } else {
-            current->prev->next = current->next;
-            current->next->prev = current->prev;
-        }
-        delete current;
-    }
-
-    void getValue(int value) override {
-        Node* current = head;
-        while (current != nullptr) {
-            if (current->data == value) {
-                cout << "Element found: " << value << endl;
-                return;
-            }
-            current = current->next;
-        }
-        cout << "Element not found: " << value << endl;
-    }
-
-    void displayList() override {
-        Node* current = head;
-        while (current != nullptr) {
-            cout << current->data << " ";
-            current = current->next;
-        }
-        cout << endl;
-    }
-
-    void saveToFile(const string& filename) override {
-        ofstream outFile(filename);
-        if (outFile.is_open()) {
-            Node* current = head;
-            while (current != nullptr) {
-                outFile << current->data << endl;
-                current = current->next;
-            }
-            outFile.close();
-        } else {
-            cerr << "Unable to open file for writing!" << endl;
-        }
-    }
-
-    void loadFromFile(const string& filename) override {
-        ifstream inFile(filename);
-        if (inFile.is_open()) {
-            int value;
-            while (inFile >> value) {
-                addToHead(value);
-            }
-            inFile.close();
-        } else {
-            cerr << "Unable to open file for reading!" << endl;
-        }
-    }
-
-    void printList() override {
-        displayList();
-    }
-
-private:
-    Node* head;
-    Node* tail;
-};
-
-// Реализация односвязного списка
-class SinglyLinkedList : public ListInterface {
-public:
-    SinglyLinkedList() : head(nullptr) {}
-
-    void addToHead(int value) override {
-        SingleNode* newNode = new SingleNode(value);
-        newNode->next = head;
-        head = newNode;
-    }
-
-    void addToTail(int value) override {
-        SingleNode* newNode = new SingleNode(value);
-        if (head == nullptr) {
-            head = newNode;
-        } else {
-            SingleNode* current = head;
-            while (current->next != nullptr) {
-                current = current->next;
-            }
-            current->next = newNode;
-        }
-    }
+#include "list.h"
+#include "batch.h"
+#include "metrics.h"
+#include "output.h"
+#include "parser.h"
+#include "server.h"
 
-    void deleteByValue(int value) override {
-        if (head == nullptr) return;
-        
-        if (head->data == value) {
-            SingleNode* temp = head;
-            head = head->next;
-            delete temp;
-            return;
-        }
-
-        SingleNode* current = head;
-        while (current->next != nullptr && current->next->data != value) {
-            current = current->next;
-        }
-
-        if (current->next == nullptr) return;
-
-        SingleNode* temp = current->next;
-        current->next = current->next->next;
-        delete temp;
-    }
-
-    void getValue(int value) override {
-        SingleNode* current = head;
-        while (current != nullptr) {
-            if (current->data == value) {
-                cout << "Element found: " << value << endl;
-                return;
-            }
-            current = current->next;
-        }
-        cout << "Element not found: " << value << endl;
-    }
-
-    void displayList() override {
-        SingleNode* current = head;
-        while (current != nullptr) {
-            cout << current->data << " ";
-            current = current->next;
-        }
-        cout << endl;
-    }
-
-    void saveToFile(const string& filename) override {
-        ofstream outFile(filename);
-        if (outFile.is_open()) {
-            SingleNode* current = head;
-            while (current != nullptr) {
-                outFile << current->data << endl;
-                current = current->next;
-            }
-            outFile.close();
-        } else {
-            cerr << "Unable to open file for writing!" << endl;
-        }
-    }
-
-    void loadFromFile(const string& filename) override {
-        ifstream inFile(filename);
-        if (inFile.is_open()) {
-            int value;
-            while (inFile >> value) {
-                addToHead(value);
-            }
-            inFile.close();
-        } else {
-            cerr << "Unable to open file for reading!" << endl;
-        }
-    }
-
-    void printList() override {
-        displayList();
-    }
-
-private:
-    SingleNode* head;
-};
+using namespace std;
 
-// Обработка команд
-void processCommand(ListInterface& list, const string& command) {
-    string cmd;
-    int value;
-    istringstream iss(command);
-    iss >> cmd;
+// Обработка команд; List - конкретный класс списка, поэтому вызовы его методов
+// не виртуальные и встраиваются
+template <typename List>
+bool executeCommand(List& list, string_view command, Output& out) {
+    Tokenizer tokens(command);
+    string_view cmd = tokens.next();
+    int64_t value = 0;
 
     if (cmd == "LPUSH") {
-        iss >> value;
+        tokens.nextNumber(value);
         list.addToHead(value);
-        cout << "Added " << value << " to head" << endl;
+        out.done("Added ", value, " to head");
     } else if (cmd == "RPUSH") { // Добавляем новую команду
-        iss >> value;
+        tokens.nextNumber(value);
         list.addToTail(value);
-        cout << "Added " << value << " to tail" << endl;
+        out.done("Added ", value, " to tail");
     } else if (cmd == "LDEL") {
-        iss >> value;
+        tokens.nextNumber(value);
         list.deleteByValue(value);
-        cout << "Deleted " << value << endl;
+        out.done("Deleted ", value);
     } else if (cmd == "LGET") {
-        iss >> value;
-        list.getValue(value);
+        tokens.nextNumber(value);
+        if (list.contains(value)) {
+            out.value(value, "Element found: ", value);
+        } else {
+            out.missing("Element not found: ", value);
+        }
     } else if (cmd == "LPRINT") {
-        list.printList();
+        out.values(list.length(), [&](ostream& stream) { list.printList(stream); },
+                   [&](auto visit) { list.forEach(visit); });
+    } else if (cmd == "STATS") {
+        out.report([&](ostream& stream) {
+            metrics.report(tokens, {{"elements", "Number of elements", static_cast<double>(list.length())}}, {},
+                           stream);
+        });
     } else {
-        cout << "Unknown command: " << command << endl;
+        out.error("Unknown command: ", command);
+        return false;
+    }
+    return true;
+}
+
+// Выполнение команды с учетом в метриках
+template <typename List>
+bool processCommand(List& list, string_view command, Output& out) {
+    return measureCommand(command, [&]() { return executeCommand(list, command, out); });
+}
+
+// Выполнение режима над списком выбранного типа
+template <typename List>
+int run(const string& filename, const string& modeFlag, const string& argument, OutputFormat format, SnapshotFormat snapshotFormat) {
+    List list;
+    auto start = chrono::steady_clock::now();
+    list.loadFromFile(filename);
+    metrics.recordLoad(Metrics::since(start));
+    auto handle = [&list, format](string_view command, ostream& stream) {
+        Output out(stream, format);
+        return processCommand(list, command, out);
+    };
+    auto save = [&list, &filename, snapshotFormat]() {
+        auto start = chrono::steady_clock::now();
+        list.saveToFile(filename, snapshotFormat);
+        metrics.recordSave(Metrics::since(start));
+    };
+    if (modeFlag == "--serve") {
+        return server::runServer(argument, handle, save, format);
+    }
+    if (modeFlag == "--batch" || modeFlag == "--replay") {
+        bool done = modeFlag == "--batch" ? batch::runBatch(argument, handle) : batch::runReplay(argument, handle);
+        if (done && modeFlag == "--batch") {  // Воспроизведение трассы не меняет файл данных
+            save();
+        }
+        return done ? 0 : 1;
+    }
+    Output out(cout, format);
+    processCommand(list, argument, out);
+    if (out.text()) {  // Весь список печатается только в текстовом режиме
+        list.displayList();
     }
+    save();
+    return 0;
 }
 
 int main(int argc, char* argv[]) {
+    OutputFormat format = OutputFormat::Text;
+    if (!takeOutputFlags(argc, argv, format)) {
+        cerr << "Invalid output format!" << endl;
+        return 1;
+    }
+    SnapshotFormat snapshotFormat = SnapshotFormat::Text;
+    takeSnapshotFlags(argc, argv, snapshotFormat);  // --compress: файл данных в сжатом формате
     if (argc != 7) {
-        cerr << "Usage: " << argv[0] << " --file filename --type single|double --query 'COMMAND'" << endl;
+        cerr << "Usage: " << argv[0] << " --file filename --type single|double --query 'COMMAND' | --batch file | --replay file | --serve address [--compress] [--quiet | --output text|json|binary]" << endl;
         return 1;
     }
 
@@ -280,31 +113,21 @@ int main(int argc, char* argv[]) {
     string filename = argv[2];
     string typeFlag = argv[3];
     string listType = argv[4];
-    string queryFlag = argv[5];
-    string query = argv[6];
+    string modeFlag = argv[5];
+    string argument = argv[6];  // Команда, файл с командами или адрес сервера
 
-    if (fileFlag != "--file" || typeFlag != "--type" || queryFlag != "--query") {
+    if (fileFlag != "--file" || typeFlag != "--type" || (modeFlag != "--query" && modeFlag != "--batch" && modeFlag != "--replay" && modeFlag != "--serve")) {
         cerr << "Invalid flags!" << endl;
         return 1;
     }
 
-    ListInterface* list = nullptr;
-
+    // Тип списка выбирается один раз: дальше все команды идут через run<List>
     if (listType == "single") {
-        list = new SinglyLinkedList();
-    } else if (listType == "double") {
-        list = new DoublyLinkedList();
-    } else {
-        cerr << "Invalid list type!" << endl;
-        return 1;
+        return run<SinglyLinkedList<int64_t>>(filename, modeFlag, argument, format, snapshotFormat);
     }
-
-    list->loadFromFile(filename);
-    processCommand(*list, query);
-    list->displayList();
-    list->saveToFile(filename);
-
-    delete list;
-    return 0;
+    if (listType == "double") {
+        return run<DoublyLinkedList<int64_t>>(filename, modeFlag, argument, format, snapshotFormat);
+    }
+    cerr << "Invalid list type!" << endl;
+    return 1;
 }
-
@@ -0,0 +1,305 @@
+#ifndef LIST_H
+#define LIST_H
+
+#include <iostream>
+#include <fstream>
+#include <functional>
+#include <string>
+#include <string_view>
+
+#include "snapshot.h"
+#include "traits.h"
+
+using namespace std;
+
+// Узел для двусвязного списка
+template <typename T>
+struct DoubleNode {
+    T data;
+    DoubleNode<T>* next;
+    DoubleNode<T>* prev;
+
+    DoubleNode(const T& value) : data(value), next(nullptr), prev(nullptr) {}
+};
+
+// Узел для односвязного списка
+template <typename T>
+struct SingleNode {
+    T data;
+    SingleNode<T>* next;
+
+    SingleNode(const T& value) : data(value), next(nullptr) {}
+};
+
+// Интерфейс для общих операций списка элементов типа T
+template <typename T>
+class ListInterface {
+public:
+    virtual ~ListInterface() = default;
+    virtual void addToHead(const T& value) = 0;
+    virtual void addToTail(const T& value) = 0; // Добавляем новую команду
+    virtual void deleteByValue(const T& value) = 0;
+    virtual bool contains(const T& value) = 0;
+    virtual int length() = 0;
+    virtual void forEach(const function<void(const T&)>& visit) = 0;
+    virtual void getValue(const T& value, ostream& out = cout) = 0;
+    virtual void displayList(ostream& out = cout) = 0;
+    virtual void saveToFile(const string& filename, SnapshotFormat format = SnapshotFormat::Text) = 0;
+    virtual void loadFromFile(const string& filename) = 0;
+    virtual void printList(ostream& out = cout) = 0;
+};
+
+// Реализация двусвязного списка
+template <typename T>
+class DoublyLinkedList final : public ListInterface<T> {
+public:
+    DoublyLinkedList() : head(nullptr), tail(nullptr), count(0) {}
+
+    ~DoublyLinkedList() override {
+        while (head != nullptr) {  // Освобождение всех узлов
+            DoubleNode<T>* temp = head;
+            head = head->next;
+            delete temp;
+        }
+    }
+
+    void addToHead(const T& value) override {
+        DoubleNode<T>* newNode = new DoubleNode<T>(value);
+        if (head == nullptr) {
+            head = tail = newNode;
+        } else {
+            newNode->next = head;
+            head->prev = newNode;
+            head = newNode;
+        }
+        count++;
+    }
+
+    void addToTail(const T& value) override {
+        DoubleNode<T>* newNode = new DoubleNode<T>(value);
+        if (tail == nullptr) {
+            head = tail = newNode;
+        } else {
+            newNode->prev = tail;
+            tail->next = newNode;
+            tail = newNode;
+        }
+        count++;
+    }
+
+    void deleteByValue(const T& value) override {
+        DoubleNode<T>* current = head;
+        while (current != nullptr && current->data != value) {
+            current = current->next;
+        }
+        if (current == nullptr) return;
+
+        if (current == head) {
+            head = head->next;
+            if (head != nullptr) head->prev = nullptr;
+        } else if (current == tail) {
+            tail = tail->prev;
+            if (tail != nullptr) tail->next = nullptr;
+        } else {
+            current->prev->next = current->next;
+            current->next->prev = current->prev;
+        }
+        delete current;
+        count--;
+    }
+
+    // Поиск значения без вывода
+    bool contains(const T& value) override {
+        DoubleNode<T>* current = head;
+        while (current != nullptr) {
+            if (current->data == value) {
+                return true;
+            }
+            current = current->next;
+        }
+        return false;
+    }
+
+    // Количество элементов
+    int length() override {
+        return count;
+    }
+
+    // Обход элементов от головы к хвосту; шаблонная версия встраивается в вызывающий код
+    template <typename F>
+    void forEach(F visit) {
+        for (DoubleNode<T>* current = head; current != nullptr; current = current->next) {
+            visit(current->data);
+        }
+    }
+
+    void forEach(const function<void(const T&)>& visit) override {
+        forEach<const function<void(const T&)>&>(visit);
+    }
+
+    void getValue(const T& value, ostream& out = cout) override {
+        if (contains(value)) {
+            out << "Element found: " << printed<T>(value) << '\n';
+        } else {
+            out << "Element not found: " << printed<T>(value) << '\n';
+        }
+    }
+
+    void displayList(ostream& out = cout) override {
+        DoubleNode<T>* current = head;
+        while (current != nullptr) {
+            out << printed<T>(current->data) << " ";
+            current = current->next;
+        }
+        out << '\n';
+    }
+
+    void saveToFile(const string& filename, SnapshotFormat format = SnapshotFormat::Text) override {
+        if (!snapshot::save<T>(filename, format, [&](auto put) { forEach(put); })) {
+            cerr << "Unable to open file for writing!" << endl;
+        }
+    }
+
+    void loadFromFile(const string& filename) override {
+        if (!snapshot::load<T>(filename, [&](const T& value) { addToHead(value); })) {
+            cerr << "Unable to open file for reading!" << endl;
+        }
+    }
+
+    void printList(ostream& out = cout) override {
+        displayList(out);
+    }
+
+private:
+    DoubleNode<T>* head;
+    DoubleNode<T>* tail;
+    int count;  // Количество элементов
+};
+
+// Реализация односвязного списка
+template <typename T>
+class SinglyLinkedList final : public ListInterface<T> {
+public:
+    SinglyLinkedList() : head(nullptr), count(0) {}
+
+    ~SinglyLinkedList() override {
+        while (head != nullptr) {  // Освобождение всех узлов
+            SingleNode<T>* temp = head;
+            head = head->next;
+            delete temp;
+        }
+    }
+
+    void addToHead(const T& value) override {
+        SingleNode<T>* newNode = new SingleNode<T>(value);
+        newNode->next = head;
+        head = newNode;
+        count++;
+    }
+
+    void addToTail(const T& value) override {
+        SingleNode<T>* newNode = new SingleNode<T>(value);
+        if (head == nullptr) {
+            head = newNode;
+        } else {
+            SingleNode<T>* current = head;
+            while (current->next != nullptr) {
+                current = current->next;
+            }
+            current->next = newNode;
+        }
+        count++;
+    }
+
+    void deleteByValue(const T& value) override {
+        if (head == nullptr) return;
+        
+        if (head->data == value) {
+            SingleNode<T>* temp = head;
+            head = head->next;
+            delete temp;
+            count--;
+            return;
+        }
+
+        SingleNode<T>* current = head;
+        while (current->next != nullptr && current->next->data != value) {
+            current = current->next;
+        }
+
+        if (current->next == nullptr) return;
+
+        SingleNode<T>* temp = current->next;
+        current->next = current->next->next;
+        delete temp;
+        count--;
+    }
+
+    // Поиск значения без вывода
+    bool contains(const T& value) override {
+        SingleNode<T>* current = head;
+        while (current != nullptr) {
+            if (current->data == value) {
+                return true;
+            }
+            current = current->next;
+        }
+        return false;
+    }
+
+    // Количество элементов
+    int length() override {
+        return count;
+    }
+
+    // Обход элементов от головы к хвосту; шаблонная версия встраивается в вызывающий код
+    template <typename F>
+    void forEach(F visit) {
+        for (SingleNode<T>* current = head; current != nullptr; current = current->next) {
+            visit(current->data);
+        }
+    }
+
+    void forEach(const function<void(const T&)>& visit) override {
+        forEach<const function<void(const T&)>&>(visit);
+    }
+
+    void getValue(const T& value, ostream& out = cout) override {
+        if (contains(value)) {
+            out << "Element found: " << printed<T>(value) << '\n';
+        } else {
+            out << "Element not found: " << printed<T>(value) << '\n';
+        }
+    }
+
+    void displayList(ostream& out = cout) override {
+        SingleNode<T>* current = head;
+        while (current != nullptr) {
+            out << printed<T>(current->data) << " ";
+            current = current->next;
+        }
+        out << '\n';
+    }
+
+    void saveToFile(const string& filename, SnapshotFormat format = SnapshotFormat::Text) override {
+        if (!snapshot::save<T>(filename, format, [&](auto put) { forEach(put); })) {
+            cerr << "Unable to open file for writing!" << endl;
+        }
+    }
+
+    void loadFromFile(const string& filename) override {
+        if (!snapshot::load<T>(filename, [&](const T& value) { addToHead(value); })) {
+            cerr << "Unable to open file for reading!" << endl;
+        }
+    }
+
+    void printList(ostream& out = cout) override {
+        displayList(out);
+    }
+
+private:
+    SingleNode<T>* head;
+    int count;  // Количество элементов
+};
+
+#endif
@@ -0,0 +1,263 @@
+#ifndef METRICS_H
+#define METRICS_H
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <malloc.h>
+
+#include "histogram.h"
+#include "parser.h"
+
+// Метрики времени выполнения: число вызовов и гистограмма задержек по каждой команде,
+// длительности загрузки и сохранения, занятая память кучи и показатели самой структуры.
+// Доступны командой STATS каждой утилиты:
+//   STATS                  - сводка в текстовом виде
+//   STATS PROMETHEUS       - текстовый формат Prometheus в ответе
+//   STATS EXPORT path      - то же в файл (атомарно, через временный файл и rename)
+// Метрики свои у каждого потока, поэтому шарды (shard.h) пишут их без синхронизации,
+// а STATS отправляется во все шарды и возвращает сводку по каждому.
+
+// Число в структуре (количество элементов, число цепочек и т.п.)
+struct Gauge {
+    const char* name;
+    const char* help;
+    double value;
+};
+
+// Распределение небольших целых величин (длины цепочек, число проверок при поиске):
+// counts[i] - сколько раз встретилось значение i, последняя ячейка - "size-1 и больше"
+struct Distribution {
+    const char* name;
+    const char* help;
+    const uint64_t* counts;
+    int size;
+};
+
+class Metrics {
+public:
+    int shard = -1;  // Номер шарда потока или -1 вне шардированного режима
+
+    ~Metrics() {
+        for (CommandMetrics* command : commands) {
+            delete command;
+        }
+    }
+
+    // Неизвестные команды учитываются под одним именем, чтобы клиент не мог
+    // создать произвольное число рядов метрик
+    void recordCommand(std::string_view name, uint64_t nanos, bool known) {
+        CommandMetrics* command = find(known ? name : "unknown");
+        command->calls++;
+        command->latency.record(nanos);
+    }
+
+    void recordLoad(uint64_t nanos) {
+        loadNanos = nanos;
+    }
+
+    void recordSave(uint64_t nanos) {
+        lastSaveNanos = nanos;
+        saves++;
+    }
+
+    // Ответ на STATS; arguments - токены после имени команды
+    void report(Tokenizer& arguments, const std::vector<Gauge>& gauges,
+                const std::vector<Distribution>& distributions, std::ostream& out) const {
+        std::string_view mode = arguments.next();
+        if (mode.empty()) {
+            writeText(gauges, distributions, out);
+        } else if (mode == "PROMETHEUS") {
+            writePrometheus(gauges, distributions, out);
+        } else if (mode == "EXPORT") {
+            std::string path(arguments.next());
+            if (path.empty()) {
+                out << "Usage: STATS EXPORT path" << '\n';
+                return;
+            }
+            if (shard >= 0) {
+                path += "." + std::to_string(shard);  // Каждый шард пишет свой файл
+            }
+            std::string temporary = path + ".tmp";
+            std::ofstream outFile(temporary);
+            if (!outFile.is_open()) {
+                out << "Unable to open file for writing!" << '\n';
+                return;
+            }
+            writePrometheus(gauges, distributions, outFile);
+            outFile.close();
+            if (std::rename(temporary.c_str(), path.c_str()) != 0) {
+                out << "Unable to write " << path << '\n';
+                return;
+            }
+            out << "Metrics written to " << path << '\n';
+        } else {
+            out << "Usage: STATS [PROMETHEUS | EXPORT path]" << '\n';
+        }
+    }
+
+    static uint64_t since(std::chrono::steady_clock::time_point start) {
+        return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now() - start).count());
+    }
+
+    // Занятая память кучи процесса (glibc), включая блоки, выделенные через mmap
+    static uint64_t heapBytes() {
+        struct mallinfo2 info = mallinfo2();
+        return info.uordblks + info.hblkhd;
+    }
+
+private:
+    struct CommandMetrics {
+        std::string name;
+        uint64_t calls = 0;
+        LatencyHistogram latency;
+    };
+
+    // Различных команд единицы, поэтому линейный поиск быстрее хеширования
+    CommandMetrics* find(std::string_view name) {
+        for (CommandMetrics* command : commands) {
+            if (command->name == name) return command;
+        }
+        CommandMetrics* command = new CommandMetrics();
+        command->name.assign(name);
+        commands.push_back(command);
+        return command;
+    }
+
+    void writeText(const std::vector<Gauge>& gauges, const std::vector<Distribution>& distributions,
+                   std::ostream& out) const {
+        char line[256];
+        if (shard >= 0) {
+            out << "shard: " << shard << "\n";
+        }
+        for (const Gauge& gauge : gauges) {
+            out << gauge.name << ": " << static_cast<long long>(gauge.value) << "\n";
+        }
+        out << "heap_bytes: " << heapBytes() << "\n";
+        std::snprintf(line, sizeof(line), "load_ms: %.3f\nlast_save_ms: %.3f\nsaves: %llu\n", loadNanos / 1e6,
+                      lastSaveNanos / 1e6, static_cast<unsigned long long>(saves));
+        out << line;
+        for (const CommandMetrics* command : commands) {
+            const LatencyHistogram& h = command->latency;
+            std::snprintf(line, sizeof(line),
+                          "command %s: calls=%llu mean_ns=%.0f p50_ns=%llu p99_ns=%llu p99.9_ns=%llu max_ns=%llu\n",
+                          command->name.c_str(), static_cast<unsigned long long>(command->calls), h.mean(),
+                          static_cast<unsigned long long>(h.percentile(50)),
+                          static_cast<unsigned long long>(h.percentile(99)),
+                          static_cast<unsigned long long>(h.percentile(99.9)),
+                          static_cast<unsigned long long>(h.max()));
+            out << line;
+        }
+        for (const Distribution& distribution : distributions) {
+            out << distribution.name << ":";
+            for (int i = 0; i < distribution.size; ++i) {
+                if (distribution.counts[i] == 0) continue;
+                out << " " << i << (i == distribution.size - 1 ? "+" : "") << "=" << distribution.counts[i];
+            }
+            out << "\n";
+        }
+    }
+
+    // Метка shard="N" для шардированного режима
+    std::string labels(const std::string& extra = std::string()) const {
+        std::string result = extra;
+        if (shard >= 0) {
+            if (!result.empty()) result += ",";
+            result += "shard=\"" + std::to_string(shard) + "\"";
+        }
+        return result.empty() ? result : "{" + result + "}";
+    }
+
+    void writePrometheus(const std::vector<Gauge>& gauges, const std::vector<Distribution>& distributions,
+                         std::ostream& out) const {
+        // Границы корзин задержки в секундах (le) для экспорта гистограмм
+        static const double bounds[] = {250e-9, 500e-9, 1e-6, 2.5e-6, 5e-6, 10e-6, 25e-6, 50e-6,
+                                        100e-6, 250e-6, 500e-6, 1e-3, 2.5e-3, 5e-3, 10e-3, 100e-3};
+
+        for (const Gauge& gauge : gauges) {
+            out << "# HELP dbms_" << gauge.name << " " << gauge.help << "\n";
+            out << "# TYPE dbms_" << gauge.name << " gauge\n";
+            out << "dbms_" << gauge.name << labels() << " " << gauge.value << "\n";
+        }
+        out << "# HELP dbms_heap_bytes Heap memory in use by the process\n# TYPE dbms_heap_bytes gauge\n";
+        out << "dbms_heap_bytes" << labels() << " " << heapBytes() << "\n";
+        out << "# HELP dbms_load_seconds Duration of the last loadFromFile\n# TYPE dbms_load_seconds gauge\n";
+        out << "dbms_load_seconds" << labels() << " " << loadNanos / 1e9 << "\n";
+        out << "# HELP dbms_save_seconds Duration of the last saveToFile\n# TYPE dbms_save_seconds gauge\n";
+        out << "dbms_save_seconds" << labels() << " " << lastSaveNanos / 1e9 << "\n";
+        out << "# HELP dbms_saves_total Number of snapshots written\n# TYPE dbms_saves_total counter\n";
+        out << "dbms_saves_total" << labels() << " " << saves << "\n";
+
+        out << "# HELP dbms_commands_total Executed commands\n# TYPE dbms_commands_total counter\n";
+        for (const CommandMetrics* command : commands) {
+            out << "dbms_commands_total" << labels("command=\"" + command->name + "\"") << " " << command->calls << "\n";
+        }
+        out << "# HELP dbms_command_latency_seconds Command execution time\n";
+        out << "# TYPE dbms_command_latency_seconds histogram\n";
+        for (const CommandMetrics* command : commands) {
+            const LatencyHistogram& h = command->latency;
+            std::string name = "command=\"" + command->name + "\"";
+            uint64_t cumulative = 0;
+            int bucket = 0;
+            for (double bound : bounds) {
+                uint64_t limit = static_cast<uint64_t>(bound * 1e9);
+                while (bucket < LatencyHistogram::bucketCount && LatencyHistogram::upperBound(bucket) <= limit) {
+                    cumulative += h.bucketCountAt(bucket++);
+                }
+                out << "dbms_command_latency_seconds_bucket" << labels(name + ",le=\"" + formatBound(bound) + "\"")
+                    << " " << cumulative << "\n";
+            }
+            out << "dbms_command_latency_seconds_bucket" << labels(name + ",le=\"+Inf\"") << " " << h.count() << "\n";
+            out << "dbms_command_latency_seconds_sum" << labels(name) << " " << h.valueSum() / 1e9 << "\n";
+            out << "dbms_command_latency_seconds_count" << labels(name) << " " << h.count() << "\n";
+        }
+
+        for (const Distribution& distribution : distributions) {
+            out << "# HELP dbms_" << distribution.name << " " << distribution.help << "\n";
+            out << "# TYPE dbms_" << distribution.name << " histogram\n";
+            uint64_t cumulative = 0;
+            uint64_t sum = 0;
+            for (int i = 0; i < distribution.size; ++i) {
+                cumulative += distribution.counts[i];
+                sum += distribution.counts[i] * static_cast<uint64_t>(i);
+                std::string le = i == distribution.size - 1 ? "+Inf" : std::to_string(i);
+                out << "dbms_" << distribution.name << "_bucket" << labels("le=\"" + le + "\"") << " " << cumulative
+                    << "\n";
+            }
+            out << "dbms_" << distribution.name << "_sum" << labels() << " " << sum << "\n";
+            out << "dbms_" << distribution.name << "_count" << labels() << " " << cumulative << "\n";
+        }
+    }
+
+    static std::string formatBound(double bound) {
+        char buffer[32];
+        std::snprintf(buffer, sizeof(buffer), "%g", bound);
+        return buffer;
+    }
+
+    std::vector<CommandMetrics*> commands;
+    uint64_t loadNanos = 0;
+    uint64_t lastSaveNanos = 0;
+    uint64_t saves = 0;
+};
+
+// Метрики текущего потока
+inline thread_local Metrics metrics;
+
+// Выполнение команды с учетом числа вызовов и задержки
+template <typename F>
+bool measureCommand(std::string_view command, F execute) {
+    auto start = std::chrono::steady_clock::now();
+    bool known = execute();
+    metrics.recordCommand(Tokenizer(command).next(), Metrics::since(start), known);
+    return known;
+}
+
+#endif
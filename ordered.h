@@ -0,0 +1,240 @@
+#ifndef ORDERED_H
+#define ORDERED_H
+
+#include <algorithm>
+#include <utility>
+
+#include "traits.h"
+
+// Упорядоченный индекс ключей HashTable: B+-дерево над указателями на узлы таблицы
+// (Entry - тип с полем key типа K). Пары хранятся только в таблице; индекс копирует
+// ключи лишь в разделители внутренних узлов. Листья связаны в список, так что
+// просмотр диапазона - спуск к первому ключу и проход по листьям без сортировки.
+// При удалении узлы не сливаются с соседями: опустевший узел освобождается, а высота
+// дерева не превышает высоту при наибольшем числе ключей.
+template <typename K, typename Entry>
+class OrderedIndex {
+public:
+    using KeyView = typename ValueTraits<K>::View;
+
+    // Наибольшее число записей в листе и детей во внутреннем узле
+    static const int fanout = 64;
+
+    OrderedIndex() {
+        Leaf* leaf = new Leaf();
+        root = leaf;
+        head = leaf;
+    }
+
+    ~OrderedIndex() {
+        destroy(root);
+    }
+
+    OrderedIndex(const OrderedIndex&) = delete;
+    OrderedIndex& operator=(const OrderedIndex&) = delete;
+
+    // Добавление узла таблицы; ключ не должен быть в индексе
+    void insert(Entry* entry) {
+        Path path;
+        Leaf* leaf = descend(entry->key, path);
+        int pos = leafPosition(leaf, entry->key);
+        std::move_backward(leaf->entries + pos, leaf->entries + leaf->count, leaf->entries + leaf->count + 1);
+        leaf->entries[pos] = entry;
+        if (++leaf->count <= fanout) {
+            return;
+        }
+
+        // Лист переполнен: правая половина уходит в новый лист
+        Leaf* right = new Leaf();
+        int half = leaf->count / 2;
+        right->count = leaf->count - half;
+        std::copy(leaf->entries + half, leaf->entries + leaf->count, right->entries);
+        leaf->count = half;
+        right->next = leaf->next;
+        right->prev = leaf;
+        if (leaf->next != nullptr) leaf->next->prev = right;
+        leaf->next = right;
+
+        K separator = right->entries[0]->key;
+        Node* child = right;
+        while (path.depth > 0) {
+            path.depth--;
+            Inner* parent = path.nodes[path.depth];
+            int slot = path.slots[path.depth];
+            std::move_backward(parent->keys + slot, parent->keys + parent->count - 1, parent->keys + parent->count);
+            std::move_backward(parent->children + slot + 1, parent->children + parent->count, parent->children + parent->count + 1);
+            parent->keys[slot] = std::move(separator);
+            parent->children[slot + 1] = child;
+            if (++parent->count <= fanout) {
+                return;
+            }
+
+            // Внутренний узел переполнен: средний разделитель поднимается к родителю
+            Inner* sibling = new Inner();
+            int leftCount = parent->count / 2;
+            sibling->count = parent->count - leftCount;
+            std::move(parent->keys + leftCount, parent->keys + parent->count - 1, sibling->keys);
+            std::copy(parent->children + leftCount, parent->children + parent->count, sibling->children);
+            separator = std::move(parent->keys[leftCount - 1]);
+            parent->count = leftCount;
+            child = sibling;
+        }
+
+        // Разделился корень: дерево растет на уровень
+        Inner* newRoot = new Inner();
+        newRoot->keys[0] = std::move(separator);
+        newRoot->children[0] = root;
+        newRoot->children[1] = child;
+        newRoot->count = 2;
+        root = newRoot;
+    }
+
+    // Удаление ключа; отсутствующий ключ игнорируется
+    void remove(KeyView key) {
+        Path path;
+        Leaf* leaf = descend(key, path);
+        int pos = leafPosition(leaf, key);
+        if (pos == leaf->count || leaf->entries[pos]->key != key) {
+            return;
+        }
+        std::move(leaf->entries + pos + 1, leaf->entries + leaf->count, leaf->entries + pos);
+        if (--leaf->count > 0 || leaf == root) {
+            return;
+        }
+
+        // Лист опустел: исключаем его из списка листов и из родителя
+        if (leaf->prev != nullptr) {
+            leaf->prev->next = leaf->next;
+        } else {
+            head = leaf->next;
+        }
+        if (leaf->next != nullptr) leaf->next->prev = leaf->prev;
+        delete leaf;
+
+        while (path.depth > 0) {
+            path.depth--;
+            Inner* parent = path.nodes[path.depth];
+            int slot = path.slots[path.depth];
+            std::move(parent->children + slot + 1, parent->children + parent->count, parent->children + slot);
+            if (parent->count > 1) {  // Вместе с ребенком уходит разделитель слева (у первого - справа)
+                int separator = slot > 0 ? slot - 1 : 0;
+                std::move(parent->keys + separator + 1, parent->keys + parent->count - 1, parent->keys + separator);
+            }
+            if (--parent->count > 0) {
+                break;
+            }
+            delete parent;  // Корень сюда не попадает: у него всегда не меньше двух детей
+        }
+
+        // Корень с единственным ребенком заменяется ребенком
+        while (!root->leaf && root->count == 1) {
+            Inner* old = static_cast<Inner*>(root);
+            root = old->children[0];
+            delete old;
+        }
+    }
+
+    // Обход всех узлов по возрастанию ключей; visit(const Entry&) возвращает false, чтобы остановиться
+    template <typename F>
+    void forEach(F visit) const {
+        walk(head, 0, visit);
+    }
+
+    // Обход узлов с ключом не меньше first по возрастанию ключей
+    template <typename F>
+    void forEachFrom(KeyView first, F visit) const {
+        Path path;
+        Leaf* leaf = descend(first, path);
+        walk(leaf, leafPosition(leaf, first), visit);
+    }
+
+    // Удаление всех ключей
+    void clear() {
+        destroy(root);
+        Leaf* leaf = new Leaf();
+        root = leaf;
+        head = leaf;
+    }
+
+private:
+    struct Node {
+        bool leaf;
+        int count = 0;  // Число записей листа или детей внутреннего узла
+
+        explicit Node(bool isLeaf) : leaf(isLeaf) {}
+    };
+
+    // Массивы на один элемент больше fanout: переполненный узел сразу разделяется
+    struct Leaf : Node {
+        Entry* entries[fanout + 1];
+        Leaf* prev = nullptr;
+        Leaf* next = nullptr;
+
+        Leaf() : Node(true) {}
+    };
+
+    struct Inner : Node {
+        K keys[fanout];              // keys[i] - нижняя граница ключей поддерева children[i + 1]
+        Node* children[fanout + 1];
+
+        Inner() : Node(false) {}
+    };
+
+    // Путь от корня к листу: узлы и номера детей, по которым шел спуск
+    struct Path {
+        static const int maxDepth = 16;  // 64^15 ключей - с запасом
+        Inner* nodes[maxDepth];
+        int slots[maxDepth];
+        int depth = 0;
+    };
+
+    Leaf* descend(KeyView key, Path& path) const {
+        Node* node = root;
+        while (!node->leaf) {
+            Inner* inner = static_cast<Inner*>(node);
+            int slot = static_cast<int>(std::upper_bound(inner->keys, inner->keys + inner->count - 1, key,
+                                                         [](KeyView k, const K& separator) { return k < separator; }) -
+                                        inner->keys);
+            path.nodes[path.depth] = inner;
+            path.slots[path.depth] = slot;
+            path.depth++;
+            node = inner->children[slot];
+        }
+        return static_cast<Leaf*>(node);
+    }
+
+    // Позиция первой записи листа с ключом не меньше key
+    static int leafPosition(const Leaf* leaf, KeyView key) {
+        return static_cast<int>(std::lower_bound(leaf->entries, leaf->entries + leaf->count, key,
+                                                 [](const Entry* entry, KeyView k) { return entry->key < k; }) -
+                                leaf->entries);
+    }
+
+    template <typename F>
+    static void walk(const Leaf* leaf, int pos, F& visit) {
+        for (; leaf != nullptr; leaf = leaf->next, pos = 0) {
+            for (; pos < leaf->count; ++pos) {
+                if (!visit(static_cast<const Entry&>(*leaf->entries[pos]))) {
+                    return;
+                }
+            }
+        }
+    }
+
+    static void destroy(Node* node) {
+        if (node->leaf) {
+            delete static_cast<Leaf*>(node);
+            return;
+        }
+        Inner* inner = static_cast<Inner*>(node);
+        for (int i = 0; i < inner->count; ++i) {
+            destroy(inner->children[i]);
+        }
+        delete inner;
+    }
+
+    Node* root;
+    Leaf* head;  // Самый левый лист
+};
+
+#endif
@@ -0,0 +1,352 @@
+#ifndef OUTPUT_H
+#define OUTPUT_H
+
+#include <cstdint>
+#include <cstdio>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+// Формат ответов команд (--quiet, --output text|json|binary):
+//   text   - сообщения для человека (по умолчанию)
+//   quiet  - только результаты чтения: значение на строку, пустая строка - значения нет;
+//            подтверждения изменений не печатаются, ошибки печатаются как в text
+//   json   - JSON Lines, объект на команду: {"ok":true}, {"value":42}, {"value":"v"},
+//            {"value":null}, {"error":"..."}, {"values":[1,2]}, {"values":{"k":"v"}}
+//   binary - запись на команду: байт-тег и данные, числа little-endian:
+//            'K' - изменение выполнено, 'I' + int64 - число, 'S' + u32 длина + байты - строка,
+//            'N' - значения нет, 'E' + u32 длина + байты - ошибка,
+//            'A' + u32 n + n записей 'I' - массив, 'M' + u32 n + n пар записей 'S' - словарь
+// Текстовые сообщения собираются только в режиме text, так что остальные форматы
+// не платят за форматирование. endl не используется: поток сбрасывается на границе
+// пакета (batch.h) или ответа (server.h).
+
+enum class OutputFormat { Text, Quiet, Json, Binary };
+
+// Разбор и удаление из argv флагов формата; false при неизвестном формате
+inline bool takeOutputFlags(int& argc, char* argv[], OutputFormat& format) {
+    int kept = 1;
+    for (int i = 1; i < argc; ++i) {
+        std::string_view flag = argv[i];
+        if (flag == "--quiet") {
+            format = OutputFormat::Quiet;
+        } else if (flag == "--output" && i + 1 < argc) {
+            std::string_view name = argv[++i];
+            if (name == "text") {
+                format = OutputFormat::Text;
+            } else if (name == "json") {
+                format = OutputFormat::Json;
+            } else if (name == "binary") {
+                format = OutputFormat::Binary;
+            } else {
+                return false;
+            }
+        } else {
+            argv[kept++] = argv[i];
+        }
+    }
+    argc = kept;
+    return true;
+}
+
+// Запись формата binary, разобранная обратно (сборка ответа из ответов шардов, см. shard.h)
+struct Record {
+    char tag = 0;
+    long long number = 0;                                             // 'I'
+    std::string_view text;                                            // 'S', 'E'
+    std::vector<long long> numbers;                                   // 'A'
+    std::vector<std::pair<std::string_view, std::string_view>> pairs;  // 'M'
+};
+
+// Чтение записи из data начиная с pos; строки ссылаются на data. false, если запись
+// оборвана или тег неизвестен
+inline bool readRecord(std::string_view data, size_t& pos, Record& record) {
+    auto readBits = [&](int size, uint64_t& bits) {
+        if (data.size() - pos < static_cast<size_t>(size)) {
+            return false;
+        }
+        bits = 0;
+        for (int i = 0; i < size; ++i) {
+            bits |= static_cast<uint64_t>(static_cast<unsigned char>(data[pos + i])) << (8 * i);
+        }
+        pos += size;
+        return true;
+    };
+    auto readTagged = [&](char tag, auto read) {
+        return pos < data.size() && data[pos++] == tag && read();
+    };
+    auto readNumber = [&](long long& number) {
+        uint64_t bits = 0;
+        if (!readBits(8, bits)) {
+            return false;
+        }
+        number = static_cast<long long>(bits);
+        return true;
+    };
+    auto readText = [&](std::string_view& text) {
+        uint64_t size = 0;
+        if (!readBits(4, size) || data.size() - pos < size) {
+            return false;
+        }
+        text = data.substr(pos, size);
+        pos += size;
+        return true;
+    };
+
+    if (pos >= data.size()) {
+        return false;
+    }
+    record = Record();
+    record.tag = data[pos++];
+    uint64_t count = 0;
+    switch (record.tag) {
+        case 'K':
+        case 'N':
+            return true;
+        case 'I':
+            return readNumber(record.number);
+        case 'S':
+        case 'E':
+            return readText(record.text);
+        case 'A':
+            if (!readBits(4, count)) {
+                return false;
+            }
+            for (uint64_t i = 0; i < count; ++i) {
+                long long number = 0;
+                if (!readTagged('I', [&]() { return readNumber(number); })) {
+                    return false;
+                }
+                record.numbers.push_back(number);
+            }
+            return true;
+        case 'M':
+            if (!readBits(4, count)) {
+                return false;
+            }
+            for (uint64_t i = 0; i < count; ++i) {
+                std::string_view key, item;
+                if (!readTagged('S', [&]() { return readText(key); }) ||
+                    !readTagged('S', [&]() { return readText(item); })) {
+                    return false;
+                }
+                record.pairs.emplace_back(key, item);
+            }
+            return true;
+        default:
+            return false;
+    }
+}
+
+class Output {
+public:
+    Output(std::ostream& stream, OutputFormat format) : out(stream), mode(format) {}
+
+    bool text() const {
+        return mode == OutputFormat::Text;
+    }
+
+    std::ostream& stream() {
+        return out;
+    }
+
+    // Изменение выполнено; message - сообщение режима text (может быть пустым)
+    template <typename... Args>
+    void done(const Args&... message) {
+        switch (mode) {
+            case OutputFormat::Text: line(message...); break;
+            case OutputFormat::Quiet: break;
+            case OutputFormat::Json: out << "{\"ok\":true}\n"; break;
+            case OutputFormat::Binary: out.put('K'); break;
+        }
+    }
+
+    // Результат чтения - число
+    template <typename... Args>
+    void value(long long number, const Args&... message) {
+        switch (mode) {
+            case OutputFormat::Text: line(message...); break;
+            case OutputFormat::Quiet: out << number << '\n'; break;
+            case OutputFormat::Json: out << "{\"value\":" << number << "}\n"; break;
+            case OutputFormat::Binary: out.put('I'); integer(number); break;
+        }
+    }
+
+    // Результат чтения - строка
+    template <typename... Args>
+    void value(std::string_view data, const Args&... message) {
+        switch (mode) {
+            case OutputFormat::Text: line(message...); break;
+            case OutputFormat::Quiet: out << data << '\n'; break;
+            case OutputFormat::Json: out << "{\"value\":"; quoted(data); out << "}\n"; break;
+            case OutputFormat::Binary: out.put('S'); bytes(data); break;
+        }
+    }
+
+    // Значения нет (ключ не найден, структура пуста)
+    template <typename... Args>
+    void missing(const Args&... message) {
+        switch (mode) {
+            case OutputFormat::Text: line(message...); break;
+            case OutputFormat::Quiet: out << '\n'; break;
+            case OutputFormat::Json: out << "{\"value\":null}\n"; break;
+            case OutputFormat::Binary: out.put('N'); break;
+        }
+    }
+
+    template <typename... Args>
+    void error(const Args&... message) {
+        if (mode == OutputFormat::Text || mode == OutputFormat::Quiet) {
+            line(message...);
+            return;
+        }
+        std::ostringstream text;
+        (text << ... << message);
+        if (mode == OutputFormat::Json) {
+            out << "{\"error\":";
+            quoted(text.str());
+            out << "}\n";
+        } else {
+            out.put('E');
+            bytes(text.str());
+        }
+    }
+
+    // Все элементы структуры: print(ostream&) - вывод режима text,
+    // each(visit) - обход элементов с вызовом visit(число)
+    template <typename Print, typename Each>
+    void values(size_t count, Print print, Each each) {
+        bool first = true;
+        switch (mode) {
+            case OutputFormat::Text:
+                print(out);
+                break;
+            case OutputFormat::Quiet:
+                each([&](auto item) { out << item << '\n'; });
+                break;
+            case OutputFormat::Json:
+                out << "{\"values\":[";
+                each([&](auto item) {
+                    if (!first) out << ',';
+                    first = false;
+                    out << item;
+                });
+                out << "]}\n";
+                break;
+            case OutputFormat::Binary:
+                out.put('A');
+                length(count);
+                each([&](auto item) {
+                    out.put('I');
+                    integer(item);
+                });
+                break;
+        }
+    }
+
+    // Все пары ключ-значение: each(visit) вызывает visit(key, value)
+    template <typename Print, typename Each>
+    void pairs(size_t count, Print print, Each each) {
+        bool first = true;
+        switch (mode) {
+            case OutputFormat::Text:
+                print(out);
+                break;
+            case OutputFormat::Quiet:
+                each([&](std::string_view key, std::string_view item) { out << key << ' ' << item << '\n'; });
+                break;
+            case OutputFormat::Json:
+                out << "{\"values\":{";
+                each([&](std::string_view key, std::string_view item) {
+                    if (!first) out << ',';
+                    first = false;
+                    quoted(key);
+                    out << ':';
+                    quoted(item);
+                });
+                out << "}}\n";
+                break;
+            case OutputFormat::Binary:
+                out.put('M');
+                length(count);
+                each([&](std::string_view key, std::string_view item) {
+                    out.put('S');
+                    bytes(key);
+                    out.put('S');
+                    bytes(item);
+                });
+                break;
+        }
+    }
+
+    // Произвольный текст (STATS): в json и binary передается строкой
+    template <typename Write>
+    void report(Write write) {
+        if (mode == OutputFormat::Text || mode == OutputFormat::Quiet) {
+            write(out);
+            return;
+        }
+        std::ostringstream text;
+        write(text);
+        value(std::string_view(text.str()));
+    }
+
+private:
+    template <typename... Args>
+    void line(const Args&... message) {
+        if constexpr (sizeof...(Args) > 0) {
+            (out << ... << message) << '\n';
+        }
+    }
+
+    void quoted(std::string_view data) {
+        out << '"';
+        for (char ch : data) {
+            if (ch == '"' || ch == '\\') {
+                out << '\\' << ch;
+            } else if (ch == '\n') {
+                out << "\\n";
+            } else if (ch == '\t') {
+                out << "\\t";
+            } else if (static_cast<unsigned char>(ch) < 0x20) {
+                char escape[8];
+                std::snprintf(escape, sizeof(escape), "\\u%04x", static_cast<unsigned char>(ch));
+                out << escape;
+            } else {
+                out << ch;
+            }
+        }
+        out << '"';
+    }
+
+    void integer(long long number) {
+        unsigned char buffer[8];
+        uint64_t bits = static_cast<uint64_t>(number);
+        for (int i = 0; i < 8; ++i) {
+            buffer[i] = static_cast<unsigned char>(bits >> (8 * i));
+        }
+        out.write(reinterpret_cast<const char*>(buffer), sizeof(buffer));
+    }
+
+    void length(size_t size) {
+        unsigned char buffer[4];
+        uint32_t bits = static_cast<uint32_t>(size);
+        for (int i = 0; i < 4; ++i) {
+            buffer[i] = static_cast<unsigned char>(bits >> (8 * i));
+        }
+        out.write(reinterpret_cast<const char*>(buffer), sizeof(buffer));
+    }
+
+    void bytes(std::string_view data) {
+        length(data.size());
+        out.write(data.data(), static_cast<std::streamsize>(data.size()));
+    }
+
+    std::ostream& out;
+    OutputFormat mode;
+};
+
+#endif
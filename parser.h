@@ -0,0 +1,75 @@
+#ifndef PARSER_H
+#define PARSER_H
+
+#include <charconv>
+#include <string_view>
+
+// Токенизатор запросов: разбирает строку команды на месте поверх string_view,
+// не создавая istringstream и временных строк. Общий для всех пяти утилит.
+class Tokenizer {
+public:
+    explicit Tokenizer(std::string_view input) : rest(input) {}
+
+    // Следующий токен, разделенный пробельными символами (пустой, если токенов больше нет)
+    std::string_view next() {
+        skipSpaces();
+        size_t end = 0;
+        while (end < rest.size() && !isSpace(rest[end])) {
+            ++end;
+        }
+        std::string_view token = rest.substr(0, end);
+        rest.remove_prefix(end);
+        return token;
+    }
+
+    // Разбор следующего токена как числа.
+    // При ошибке value не изменяется и возвращается false
+    template <typename T>
+    bool nextNumber(T& value) {
+        std::string_view token = next();
+        if (token.empty()) {
+            return false;
+        }
+        const char* first = token.data();
+        const char* last = token.data() + token.size();
+        if (*first == '+') {  // from_chars не принимает явный плюс, в отличие от operator>>
+            ++first;
+        }
+        T parsed{};
+        auto result = std::from_chars(first, last, parsed);
+        if (result.ec != std::errc() || result.ptr == first) {
+            return false;
+        }
+        value = parsed;
+        return true;
+    }
+
+    bool nextInt(int& value) {
+        return nextNumber(value);
+    }
+
+    // Остались ли еще токены
+    bool empty() {
+        skipSpaces();
+        return rest.empty();
+    }
+
+    // Разделитель токенов
+    static bool isSpace(char ch) {
+        return ch == ' ' || ch == '\t' || ch == '\n' || ch == '\r' || ch == '\v' || ch == '\f';
+    }
+
+private:
+
+    void skipSpaces() {
+        size_t start = 0;
+        while (start < rest.size() && isSpace(rest[start])) {
+            ++start;
+        }
+        rest.remove_prefix(start);
+    }
+
+    std::string_view rest;  // Еще не разобранная часть строки
+};
+
+#endif
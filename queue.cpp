@@ -1,156 +1,162 @@
+#include <chrono>
 #include <iostream>
 #include <fstream>
 #include <string>
-#include <sstream>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+#include "queue.h"
+#include "batch.h"
+#include "metrics.h"
+#include "output.h"
+#include "parser.h"
+#include "segment.h"
+#include "server.h"
 
 using namespace std;
 
-// Узел для очереди
-struct QueueNode {
-    int data;
-    QueueNode* next;
-
-    QueueNode(int value) : data(value), next(nullptr) {}
-};
-
-// Интерфейс для общих операций структуры данных
-class QueueInterface {
-public:
-    virtual void enqueue(int value) = 0;
-    virtual void dequeue() = 0;
-    virtual void peek() = 0;
-    virtual void displayQueue() = 0;
-    virtual void saveToFile(const string& filename) = 0;
-    virtual void loadFromFile(const string& filename) = 0;
-};
-
-// Реализация очереди
-class Queue : public QueueInterface {
-public:
-    Queue() : head(nullptr), tail(nullptr) {}
+// Обработка команд
+template <typename QueueType>
+bool executeCommand(QueueType& queue, string_view command, Output& out) {
+    Tokenizer tokens(command);
+    string_view cmd = tokens.next();
+    int64_t value = 0;
 
-    // Добавление элемента в конец
-    void enqueue(int value) override {
-        QueueNode* newNode = new QueueNode(value);
-        if (tail == nullptr) { // Если очередь пуста
-            head = tail = newNode;
+    if (cmd == "QPUSH") {
+        tokens.nextNumber(value);
+        queue.enqueue(value);
+        out.done("Added ", value, " to queue");
+    } else if (cmd == "QPUSHP" || cmd == "QPUSHD") {
+        if constexpr (is_same_v<QueueType, PriorityQueue<int64_t>>) {
+            int64_t argument = 0;  // Приоритет или задержка в миллисекундах
+            bool valid = tokens.nextNumber(argument) && tokens.nextNumber(value);
+            if (!valid) {
+                out.error(cmd == "QPUSHP" ? "Invalid priority or value!" : "Invalid delay or value!");
+            } else if (cmd == "QPUSHD" && (argument < 0 || argument > maxDelayMillis)) {
+                out.error("Invalid delay!");
+            } else if (cmd == "QPUSHP") {
+                queue.push(value, argument);
+                out.done("Added ", value, " to queue with priority ", argument);
+            } else {
+                queue.pushDelayed(value, argument);
+                out.done("Added ", value, " to queue in ", argument, " ms");
+            }
         } else {
-            tail->next = newNode;
-            tail = newNode;
+            out.error("QPUSHP and QPUSHD require --priority: ", command);
+            return false;
         }
-    }
-
-    // Удаление элемента с начала
-    void dequeue() override {
-        if (head == nullptr) {
-            cout << "Queue is empty!" << endl;
-            return;
-        }
-        QueueNode* temp = head;
-        head = head->next;
-        if (head == nullptr) { // Если очередь опустела
-            tail = nullptr;
+    } else if (cmd == "QPOP") {
+        if (queue.pop(value)) {
+            out.value(value, "Removed: ", value);
+        } else if (queue.length() > 0) {  // Сегмент --segmented не прочитался
+            out.error("Unable to read queue segment!");
+        } else {
+            out.missing("Queue is empty!");
         }
-        cout << "Removed: " << temp->data << endl;
-        delete temp;
-    }
-
-    // Получение элемента с начала очереди без удаления
-    void peek() override {
-        if (head != nullptr) {
-            cout << "Front of queue: " << head->data << endl;
+    } else if (cmd == "QPEEK") {
+        if (queue.front(value)) {
+            out.value(value, "Front of queue: ", value);
         } else {
-            cout << "Queue is empty!" << endl;
+            out.missing("Queue is empty!");
         }
-    }
-
-    // Печать всех элементов
-    void displayQueue() override {
-        QueueNode* current = head;
-        while (current != nullptr) {
-            cout << current->data << " ";
-            current = current->next;
+    } else if (cmd == "QPRINT") {
+        out.values(queue.length(), [&](ostream& stream) { queue.displayQueue(stream); },
+                   [&](auto visit) { queue.forEach(visit); });
+    } else if (cmd == "STATS") {
+        vector<Gauge> gauges = {{"elements", "Number of elements", static_cast<double>(queue.length())}};
+        if constexpr (is_same_v<QueueType, PriorityQueue<int64_t>>) {
+            gauges.push_back({"delayed_elements", "Number of delayed elements", static_cast<double>(queue.delayedLength())});
         }
-        cout << endl;
+        out.report([&](ostream& stream) { metrics.report(tokens, gauges, {}, stream); });
+    } else {
+        out.error("Unknown command: ", command);
+        return false;
     }
+    return true;
+}
 
-    // Сохранение очереди в файл
-    void saveToFile(const string& filename) override {
-        ofstream outFile(filename);
-        if (outFile.is_open()) {
-            QueueNode* current = head;
-            while (current != nullptr) {
-                outFile << current->data << endl;
-                current = current->next;
-            }
-            outFile.close();
-        } else {
-            cerr << "Unable to open file for writing!" << endl;
+// Выполнение команды с учетом в метриках
+template <typename QueueType>
+bool processCommand(QueueType& queue, string_view command, Output& out) {
+    return measureCommand(command, [&]() { return executeCommand(queue, command, out); });
+}
+
+// Загрузка, выполнение команд и сохранение для выбранной реализации
+template <typename QueueType>
+int run(const string& filename, const string& modeFlag, const string& argument, OutputFormat format, SnapshotFormat snapshotFormat) {
+    QueueType queue;
+    if constexpr (!is_same_v<QueueType, PriorityQueue<int64_t>>) {
+        if (isPriorityFile(filename)) {  // Файл не загружается и не перезаписывается
+            cerr << "Data file is a priority queue: use --priority!" << endl;
+            return 1;
         }
     }
 
-    // Загрузка очереди из файла
-    void loadFromFile(const string& filename) override {
-        ifstream inFile(filename);
-        if (inFile.is_open()) {
-            int value;
-            while (inFile >> value) {
-                enqueue(value);
-            }
-            inFile.close();
-        } else {
-            cerr << "Unable to open file for reading!" << endl;
+    auto start = chrono::steady_clock::now();
+    queue.loadFromFile(filename);
+    metrics.recordLoad(Metrics::since(start));
+    auto handle = [&queue, format](string_view command, ostream& stream) {
+        Output out(stream, format);
+        return processCommand(queue, command, out);
+    };
+    auto save = [&queue, &filename, snapshotFormat]() {
+        auto start = chrono::steady_clock::now();
+        queue.saveToFile(filename, snapshotFormat);
+        metrics.recordSave(Metrics::since(start));
+    };
+    if (modeFlag == "--serve") {
+        return server::runServer(argument, handle, save, format);
+    }
+    if (modeFlag == "--batch" || modeFlag == "--replay") {
+        bool done = modeFlag == "--batch" ? batch::runBatch(argument, handle) : batch::runReplay(argument, handle);
+        if (done && modeFlag == "--batch") {  // Воспроизведение трассы не меняет файл данных
+            save();
         }
+        return done ? 0 : 1;
     }
+    Output out(cout, format);
+    processCommand(queue, argument, out);
+    save();
 
-private:
-    QueueNode* head;
-    QueueNode* tail;
-};
-
-// Обработка команд
-void processCommand(QueueInterface& queue, const string& command) {
-    string cmd;
-    int value;
-    istringstream iss(command);
-    iss >> cmd;
-
-    if (cmd == "QPUSH") {
-        iss >> value;
-        queue.enqueue(value);
-        cout << "Added " << value << " to queue" << endl;
-    } else if (cmd == "QPOP") {
-        queue.dequeue();
-    } else if (cmd == "QPEEK") {
-        queue.peek();
-    } else if (cmd == "QPRINT") {
-        queue.displayQueue();
-    } else {
-        cout << "Unknown command: " << command << endl;
-    }
+    return 0;
 }
 
 int main(int argc, char* argv[]) {
-    if (argc != 5) {
-        cerr << "Usage: " << argv[0] << " --file filename --query 'COMMAND'" << endl;
+    OutputFormat format = OutputFormat::Text;
+    if (!takeOutputFlags(argc, argv, format)) {
+        cerr << "Invalid output format!" << endl;
+        return 1;
+    }
+    SnapshotFormat snapshotFormat = SnapshotFormat::Text;
+    takeSnapshotFlags(argc, argv, snapshotFormat);  // --compress: файл данных в сжатом формате
+    bool segmented = takeSegmentedFlag(argc, argv);  // --segmented: файл данных из сегментов, см. segment.h
+    bool priority = takePriorityFlag(argc, argv);    // --priority: QPUSHP/QPUSHD, задания по приоритету
+    if (priority && snapshotFormat == SnapshotFormat::Compressed) {  // Приоритеты и сроки хранятся только текстом
+        cerr << "--compress is not supported with --priority!" << endl;
+        return 1;
+    }
+    if (argc != 5 || (segmented && priority)) {
+        cerr << "Usage: " << argv[0] << " --file filename --query 'COMMAND' | --batch file | --replay file | --serve address [--compress | --segmented | --priority] [--quiet | --output text|json|binary]" << endl;
         return 1;
     }
 
     string fileFlag = argv[1];
     string filename = argv[2];
-    string queryFlag = argv[3];
-    string query = argv[4];
+    string modeFlag = argv[3];
+    string argument = argv[4];  // Команда, файл с командами или адрес сервера
 
-    if (fileFlag != "--file" || queryFlag != "--query") {
+    if (fileFlag != "--file" || (modeFlag != "--query" && modeFlag != "--batch" && modeFlag != "--replay" && modeFlag != "--serve")) {
         cerr << "Invalid flags!" << endl;
         return 1;
     }
 
-    Queue queue;
-
-    queue.loadFromFile(filename);
-    processCommand(queue, query);
-    queue.saveToFile(filename);
-
-    return 0;
+    // Реализация выбирается один раз: дальше все команды идут через run<QueueType>
+    if (segmented) {
+        return run<SegmentedQueue<int64_t>>(filename, modeFlag, argument, format, snapshotFormat);
+    }
+    if (priority) {
+        return run<PriorityQueue<int64_t>>(filename, modeFlag, argument, format, snapshotFormat);
+    }
+    return run<Queue<int64_t>>(filename, modeFlag, argument, format, snapshotFormat);
 }
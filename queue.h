@@ -0,0 +1,421 @@
+#ifndef QUEUE_H
+#define QUEUE_H
+
+#include <algorithm>
+#include <cstdint>
+#include <iostream>
+#include <fstream>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "heap.h"
+#include "parser.h"
+#include "snapshot.h"
+#include "timer.h"
+#include "traits.h"
+
+using namespace std;
+
+// Узел для очереди
+template <typename T>
+struct QueueNode {
+    T data;
+    QueueNode<T>* next;
+
+    QueueNode(const T& value) : data(value), next(nullptr) {}
+};
+
+// Интерфейс для общих операций очереди элементов типа T
+template <typename T>
+class QueueInterface {
+public:
+    virtual ~QueueInterface() = default;
+    virtual void enqueue(const T& value) = 0;
+    virtual bool pop(T& value) = 0;
+    virtual bool front(T& value) = 0;
+    virtual int length() = 0;
+    virtual void forEach(const function<void(const T&)>& visit) = 0;
+    virtual void dequeue(ostream& out = cout) = 0;
+    virtual void peek(ostream& out = cout) = 0;
+    virtual void displayQueue(ostream& out = cout) = 0;
+    virtual void saveToFile(const string& filename, SnapshotFormat format = SnapshotFormat::Text) = 0;
+    virtual void loadFromFile(const string& filename) = 0;
+};
+
+// Реализация очереди
+template <typename T>
+class Queue final : public QueueInterface<T> {
+public:
+    Queue() : head(nullptr), tail(nullptr), count(0) {}
+
+    ~Queue() override {
+        clear();  // Освобождение памяти при удалении очереди
+    }
+
+    // Добавление элемента в конец
+    void enqueue(const T& value) override {
+        QueueNode<T>* newNode = new QueueNode<T>(value);
+        if (tail == nullptr) { // Если очередь пуста
+            head = tail = newNode;
+        } else {
+            tail->next = newNode;
+            tail = newNode;
+        }
+        count++;
+    }
+
+    // Извлечение элемента с начала без вывода; false, если очередь пуста
+    bool pop(T& value) override {
+        if (head == nullptr) {
+            return false;
+        }
+        QueueNode<T>* temp = head;
+        head = head->next;
+        if (head == nullptr) { // Если очередь опустела
+            tail = nullptr;
+        }
+        value = temp->data;
+        delete temp;
+        count--;
+        return true;
+    }
+
+    // Элемент в начале очереди без удаления; false, если очередь пуста
+    bool front(T& value) override {
+        if (head == nullptr) {
+            return false;
+        }
+        value = head->data;
+        return true;
+    }
+
+    // Количество элементов
+    int length() override {
+        return count;
+    }
+
+    // Обход элементов от начала к концу; шаблонная версия встраивается в вызывающий код
+    template <typename F>
+    void forEach(F visit) {
+        for (QueueNode<T>* current = head; current != nullptr; current = current->next) {
+            visit(current->data);
+        }
+    }
+
+    void forEach(const function<void(const T&)>& visit) override {
+        forEach<const function<void(const T&)>&>(visit);
+    }
+
+    // Удаление всех элементов
+    void clear() {
+        T value;
+        while (pop(value)) {}
+    }
+
+    // Удаление элемента с начала
+    void dequeue(ostream& out = cout) override {
+        T value;
+        if (pop(value)) {
+            out << "Removed: " << printed<T>(value) << '\n';
+        } else {
+            out << "Queue is empty!" << '\n';
+        }
+    }
+
+    // Получение элемента с начала очереди без удаления
+    void peek(ostream& out = cout) override {
+        T value;
+        if (front(value)) {
+            out << "Front of queue: " << printed<T>(value) << '\n';
+        } else {
+            out << "Queue is empty!" << '\n';
+        }
+    }
+
+    // Печать всех элементов
+    void displayQueue(ostream& out = cout) override {
+        QueueNode<T>* current = head;
+        while (current != nullptr) {
+            out << printed<T>(current->data) << " ";
+            current = current->next;
+        }
+        out << '\n';
+    }
+
+    // Сохранение очереди в файл (текстом или в сжатом формате, см. snapshot.h)
+    void saveToFile(const string& filename, SnapshotFormat format = SnapshotFormat::Text) override {
+        if (!snapshot::save<T>(filename, format, [&](auto put) { forEach(put); })) {
+            cerr << "Unable to open file for writing!" << endl;
+        }
+    }
+
+    // Загрузка очереди из файла любого формата
+    void loadFromFile(const string& filename) override {
+        if (!snapshot::load<T>(filename, [&](const T& value) { enqueue(value); })) {
+            cerr << "Unable to open file for reading!" << endl;
+        }
+    }
+
+private:
+    QueueNode<T>* head;
+    QueueNode<T>* tail;
+    int count;  // Количество элементов
+};
+
+// Первая строка файла данных очереди с приоритетом
+const string priorityTag = "PRIORITY";
+
+// Файл записан очередью с приоритетом: обычная очередь прочитала бы приоритеты как значения
+inline bool isPriorityFile(const string& filename) {
+    ifstream inFile(filename, ios::binary);
+    string line;
+    return getline(inFile, line) && line == priorityTag;
+}
+
+// Разбор и удаление из argv флага --priority
+inline bool takePriorityFlag(int& argc, char* argv[]) {
+    bool found = false;
+    int kept = 1;
+    for (int i = 1; i < argc; ++i) {
+        if (string(argv[i]) == "--priority") {
+            found = true;
+        } else {
+            argv[kept++] = argv[i];
+        }
+    }
+    argc = kept;
+    return found;
+}
+
+// Задание очереди с приоритетом
+template <typename T>
+struct PriorityEntry {
+    int64_t priority;  // Больший приоритет извлекается раньше
+    int64_t readyAt;   // Срок готовности (wallClockMillis); 0 - готово сразу
+    uint64_t seq;      // Порядок постановки: при равном приоритете - FIFO
+    T value;
+};
+
+// Порядок извлечения готовых заданий
+struct ReadyBefore {
+    template <typename Entry>
+    bool operator()(const Entry& a, const Entry& b) const {
+        return a.priority != b.priority ? a.priority > b.priority : a.seq < b.seq;
+    }
+};
+
+// Порядок готовности отложенных заданий
+struct DelayedBefore {
+    template <typename Entry>
+    bool operator()(const Entry& a, const Entry& b) const {
+        return a.readyAt != b.readyAt ? a.readyAt < b.readyAt : a.seq < b.seq;
+    }
+};
+
+// Наибольшая задержка QPUSHD (100 лет в миллисекундах)
+const int64_t maxDelayMillis = 100LL * 365 * 24 * 3600 * 1000;
+
+// Очередь с приоритетами и отложенными заданиями (--priority): готовые задания
+// в 4-арной куче по приоритету, отложенные - во второй куче по сроку готовности.
+// Перед каждым извлечением наступившие сроки переносятся в кучу готовых, так что
+// QPOP и QPEEK - O(log n). Задания с одинаковым приоритетом выходят в порядке
+// постановки, поэтому без QPUSHP/QPUSHD очередь ведет себя как обычная.
+// Файл данных - строка priorityTag и строки "значение [приоритет [срок]]" в порядке
+// извлечения; файл обычной очереди (в том числе сжатый) загружается как задания с приоритетом 0.
+template <typename T>
+class PriorityQueue final : public QueueInterface<T> {
+public:
+    using Entry = PriorityEntry<T>;
+
+    void enqueue(const T& value) override {
+        push(value, 0);
+    }
+
+    // Добавление готового задания с приоритетом
+    void push(const T& value, int64_t priority) {
+        ready.push(Entry{priority, 0, nextSeq++, value});
+    }
+
+    // Добавление задания, которое станет готовым через delayMs миллисекунд
+    // (не больше maxDelayMillis, чтобы срок не переполнил int64_t)
+    void pushDelayed(const T& value, int64_t delayMs, int64_t priority = 0) {
+        if (delayMs <= 0) {
+            push(value, priority);
+            return;
+        }
+        if (delayMs > maxDelayMillis) {
+            delayMs = maxDelayMillis;
+        }
+        delayed.push(Entry{priority, wallClockMillis() + delayMs, nextSeq++, value});
+    }
+
+    // Извлечение готового задания; false, если готовых нет
+    bool pop(T& value) override {
+        promoteDue();
+        if (ready.empty()) {
+            return false;
+        }
+        value = ready.pop().value;
+        return true;
+    }
+
+    bool front(T& value) override {
+        promoteDue();
+        if (ready.empty()) {
+            return false;
+        }
+        value = ready.top().value;
+        return true;
+    }
+
+    // Количество заданий, включая отложенные
+    int length() override {
+        return static_cast<int>(ready.size() + delayed.size());
+    }
+
+    // Число отложенных заданий
+    size_t delayedLength() const {
+        return delayed.size();
+    }
+
+    // Обход в порядке извлечения: готовые по приоритету, затем отложенные по сроку
+    template <typename F>
+    void forEach(F visit) {
+        promoteDue();
+        forEachEntry([&](const Entry& entry) { visit(entry.value); });
+    }
+
+    void forEach(const function<void(const T&)>& visit) override {
+        forEach<const function<void(const T&)>&>(visit);
+    }
+
+    void clear() {
+        ready.clear();
+        delayed.clear();
+    }
+
+    void dequeue(ostream& out = cout) override {
+        T value;
+        if (pop(value)) {
+            out << "Removed: " << printed<T>(value) << '\n';
+        } else {
+            out << "Queue is empty!" << '\n';
+        }
+    }
+
+    void peek(ostream& out = cout) override {
+        T value;
+        if (front(value)) {
+            out << "Front of queue: " << printed<T>(value) << '\n';
+        } else {
+            out << "Queue is empty!" << '\n';
+        }
+    }
+
+    void displayQueue(ostream& out = cout) override {
+        forEach([&](const T& value) { out << printed<T>(value) << " "; });
+        out << '\n';
+    }
+
+    // Сохранение всегда текстом: сжатый формат хранит только значения
+    void saveToFile(const string& filename, SnapshotFormat = SnapshotFormat::Text) override {
+        snapshot::Manifest previous;
+        bool segmented = snapshot::readManifest(filename, previous);
+        ofstream outFile(filename);
+        if (!outFile.is_open()) {
+            cerr << "Unable to open file for writing!" << endl;
+            return;
+        }
+        outFile << priorityTag << '\n';
+        forEachEntry([&](const Entry& entry) {
+            outFile << printed<T>(entry.value);
+            if (entry.priority != 0 || entry.readyAt != 0) {
+                outFile << ' ' << entry.priority;
+            }
+            if (entry.readyAt != 0) {
+                outFile << ' ' << entry.readyAt;
+            }
+            outFile << '\n';
+        });
+        outFile.close();
+        if (segmented && outFile) {  // Файл заменил оглавление --segmented
+            snapshot::removeSegments(filename, previous);
+        }
+    }
+
+    void loadFromFile(const string& filename) override {
+        ifstream inFile(filename, ios::binary);
+        if (!inFile.is_open()) {
+            cerr << "Unable to open file for reading!" << endl;
+            return;
+        }
+        clear();
+        snapshot::Manifest manifest;
+        if (snapshot::readManifest(filename, manifest)) {  // Файл --segmented
+            if (!snapshot::loadSegments<T>(filename, manifest, [&](const T& value) { enqueue(value); })) {
+                cerr << "Unable to open file for reading!" << endl;
+            }
+            return;
+        }
+        if constexpr (snapshot::compressible<T>) {
+            if (snapshot::isCompressed(inFile)) {  // Сжатый файл обычной очереди
+                snapshot::load<T>(filename, [&](const T& value) { enqueue(value); });
+                return;
+            }
+        }
+        string line;
+        T value;
+        while (getline(inFile, line)) {
+            if (line == priorityTag) {
+                continue;
+            }
+            Tokenizer tokens(line);
+            if (tokens.empty()) {
+                continue;
+            }
+            int64_t priority = 0;
+            int64_t readyAt = 0;
+            if (!ValueTraits<T>::parse(tokens.next(), value) || (!tokens.empty() && !tokens.nextNumber(priority)) ||
+                (!tokens.empty() && !tokens.nextNumber(readyAt))) {
+                break;
+            }
+            if (readyAt == 0) {
+                push(value, priority);
+            } else {
+                delayed.push(Entry{priority, readyAt, nextSeq++, value});
+            }
+        }
+    }
+
+private:
+    // Перенос заданий с наступившим сроком в кучу готовых
+    void promoteDue() {
+        if (delayed.empty()) {
+            return;
+        }
+        int64_t now = wallClockMillis();
+        while (!delayed.empty() && delayed.top().readyAt <= now) {
+            Entry entry = delayed.pop();
+            push(entry.value, entry.priority);
+        }
+    }
+
+    // Обход заданий в порядке извлечения; куча не меняется, порядок дает сортировка копий
+    template <typename F>
+    void forEachEntry(F visit) const {
+        vector<Entry> order(ready.raw());
+        sort(order.begin(), order.end(), ReadyBefore());
+        for (const Entry& entry : order) visit(entry);
+        order = delayed.raw();
+        sort(order.begin(), order.end(), DelayedBefore());
+        for (const Entry& entry : order) visit(entry);
+    }
+
+    DaryHeap<Entry, ReadyBefore> ready;
+    DaryHeap<Entry, DelayedBefore> delayed;
+    uint64_t nextSeq = 0;
+};
+
+#endif
@@ -0,0 +1,399 @@
+#ifndef SEGMENT_H
+#define SEGMENT_H
+
+#include <cstdint>
+#include <cstddef>
+#include <cstdio>
+#include <deque>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "snapshot.h"
+#include "traits.h"
+
+using namespace std;
+
+// Сегментированное хранение очереди и стека (--segmented). Файл данных становится
+// оглавлением (snapshot::Manifest), а значения лежат в файлах сегментов filename.N
+// по segmentValues значений (сжатый формат snapshot.h).
+// В памяти держатся только крайние сегменты, поэтому загрузка, сохранение и
+// QPUSH/QPOP/SPUSH/SPOP не зависят от общего числа элементов. Обход (QPRINT, SPRINT)
+// читает остальные сегменты с диска по одному.
+// Файл сегмента после записи не меняется: новое содержимое пишется под новым номером,
+// а старый файл удаляется только после записи оглавления, так что сбой в любой момент
+// оставляет прежнее оглавление со всеми его сегментами.
+// Файл данных без оглавления (прежний формат) загружается целиком и при сохранении
+// переводится в сегменты.
+
+// Число значений в сегменте
+const size_t segmentValues = 65536;
+
+// Разбор и удаление из argv флага --segmented
+inline bool takeSegmentedFlag(int& argc, char* argv[]) {
+    bool found = false;
+    int kept = 1;
+    for (int i = 1; i < argc; ++i) {
+        if (string(argv[i]) == "--segmented") {
+            found = true;
+        } else {
+            argv[kept++] = argv[i];
+        }
+    }
+    argc = kept;
+    return found;
+}
+
+// Файлы сегментов одной структуры
+template <typename T>
+class SegmentFiles {
+public:
+    void open(const string& filename) {
+        base = filename;
+    }
+
+    // Чтение оглавления; false, если файла нет или это файл данных прежнего формата
+    bool readManifest(snapshot::Manifest& manifest) {
+        if (!snapshot::readManifest(base, manifest)) {
+            return false;
+        }
+        nextId = manifest.nextId;
+        return true;
+    }
+
+    // Номер для нового файла сегмента
+    int64_t allocate() {
+        return nextId++;
+    }
+
+    bool read(int64_t id, vector<T>& values) const {
+        values.clear();
+        return snapshot::loadValues<T>(snapshot::segmentPath(base, id), [&](const T& value) { values.push_back(value); });
+    }
+
+    // Запись сегмента из первых limit значений; файл заменяется атомарно
+    bool write(int64_t id, const vector<T>& values, size_t limit = SIZE_MAX) {
+        return replace(snapshot::segmentPath(base, id), [&](const string& temporary) {
+            return snapshot::save<T>(temporary, SnapshotFormat::Compressed, [&](auto put) {
+                for (size_t i = 0; i < values.size() && i < limit; ++i) {
+                    put(values[i]);
+                }
+            });
+        });
+    }
+
+    // Сегмент больше не нужен; файл удаляется после записи оглавления
+    void retire(int64_t id) {
+        retired.push_back(id);
+    }
+
+    // Запись оглавления и удаление вышедших из него сегментов
+    bool commit(snapshot::Manifest& manifest) {
+        manifest.nextId = nextId;
+        bool written = replace(base, [&](const string& temporary) {
+            ofstream outFile(temporary);
+            snapshot::writeManifest(outFile, manifest);
+            return static_cast<bool>(outFile);
+        });
+        if (written) {
+            for (int64_t id : retired) {
+                std::remove(snapshot::segmentPath(base, id).c_str());
+            }
+            retired.clear();
+        }
+        return written;
+    }
+
+private:
+    // Запись через временный файл и rename, чтобы сбой не оставил файл наполовину
+    template <typename Write>
+    static bool replace(const string& target, Write write) {
+        string temporary = target + ".tmp";
+        if (!write(temporary) || std::rename(temporary.c_str(), target.c_str()) != 0) {
+            cerr << "Unable to open file for writing!" << endl;
+            return false;
+        }
+        return true;
+    }
+
+    string base;              // Имя файла оглавления
+    int64_t nextId = 0;
+    vector<int64_t> retired;  // Сегменты к удалению после commit
+};
+
+// Очередь из сегментов: полные сегменты full (на диске, в памяти только головной - head)
+// и хвост tail в памяти. Без полных сегментов очередь целиком лежит в tail.
+// Оглавление: full по порядку и файл сохраненного хвоста tailId.
+template <typename T>
+class SegmentedQueue {
+public:
+    void enqueue(const T& value) {
+        if (tail.size() >= flushAt) {  // Хвост заполнен: пишем его новым сегментом
+            int64_t id = files.allocate();
+            if (files.write(id, tail)) {
+                full.push_back(id);
+                if (full.size() == 1) {
+                    head.swap(tail);
+                }
+                tail.clear();
+                flushAt = segmentValues;
+            } else {
+                flushAt += segmentValues;  // Значения остаются в памяти, повтор через сегмент
+            }
+        }
+        tail.push_back(value);
+        tailDirty = true;
+        count++;
+    }
+
+    // false, если очередь пуста или следующий сегмент не прочитался (тогда length() > 0
+    // и очередь не меняется)
+    bool pop(T& value) {
+        if (!front(value)) {
+            return false;
+        }
+        if (!full.empty() && headPos + 1 == head.size()) {  // Последнее значение головного сегмента
+            vector<T> next;  // Следующий сегмент читается до того, как текущий выйдет из оглавления
+            if (full.size() > 1 && !files.read(full[1], next)) {
+                cerr << "Unable to open file for reading!" << endl;
+                return false;
+            }
+            files.retire(full.front());
+            full.pop_front();
+            head.swap(next);
+            headPos = 0;
+            count--;
+            return true;
+        }
+        headPos++;
+        count--;
+        if (full.empty() && count == 0) {  // Очередь опустела: сегмент начинается заново
+            tail.clear();
+            headPos = 0;
+            tailDirty = true;
+        }
+        return true;
+    }
+
+    bool front(T& value) const {
+        const vector<T>& first = full.empty() ? tail : head;
+        if (count == 0 || headPos >= first.size()) {
+            return false;
+        }
+        value = first[headPos];
+        return true;
+    }
+
+    long long length() const {
+        return count;
+    }
+
+    // Обход от начала к концу; средние сегменты читаются с диска
+    template <typename F>
+    void forEach(F visit) {
+        if (full.empty()) {
+            for (size_t i = headPos; i < tail.size(); ++i) visit(tail[i]);
+            return;
+        }
+        for (size_t i = headPos; i < head.size(); ++i) visit(head[i]);
+        vector<T> middle;
+        for (size_t i = 1; i < full.size(); ++i) {
+            files.read(full[i], middle);
+            for (const T& value : middle) visit(value);
+        }
+        for (const T& value : tail) visit(value);
+    }
+
+    void displayQueue(ostream& out = cout) {
+        forEach([&](const T& value) { out << printed<T>(value) << " "; });
+        out << '\n';
+    }
+
+    // Сохранение: хвост (если менялся, под новым номером) и оглавление
+    void saveToFile(const string& filename, SnapshotFormat = SnapshotFormat::Compressed) {
+        files.open(filename);
+        if (tailDirty || tailId < 0) {
+            int64_t id = files.allocate();
+            if (!files.write(id, tail)) {
+                return;
+            }
+            if (tailId >= 0) {
+                files.retire(tailId);
+            }
+            tailId = id;
+            tailDirty = false;
+        }
+        snapshot::Manifest manifest;
+        manifest.headPos = static_cast<int64_t>(headPos);
+        manifest.count = count;
+        manifest.ids.assign(full.begin(), full.end());
+        manifest.ids.push_back(tailId);
+        files.commit(manifest);
+    }
+
+    void loadFromFile(const string& filename) {
+        files.open(filename);
+        snapshot::Manifest manifest;
+        if (!files.readManifest(manifest)) {  // Файл прежнего формата загружается целиком
+            if (!snapshot::load<T>(filename, [&](const T& value) { enqueue(value); })) {
+                cerr << "Unable to open file for reading!" << endl;
+            }
+            return;
+        }
+        if (manifest.ids.empty()) {
+            cerr << "Unable to open file for reading!" << endl;
+            return;
+        }
+        tailId = manifest.ids.back();
+        full.assign(manifest.ids.begin(), manifest.ids.end() - 1);
+        headPos = static_cast<size_t>(manifest.headPos);
+        count = manifest.count;
+        if (!files.read(tailId, tail) || (!full.empty() && !files.read(full.front(), head))) {
+            cerr << "Unable to open file for reading!" << endl;
+            full.clear();
+            head.clear();
+            tail.clear();
+            tailId = -1;
+            headPos = 0;
+            count = 0;
+        }
+    }
+
+private:
+    SegmentFiles<T> files;
+    deque<int64_t> full;   // Номера полных сегментов от головного
+    vector<T> head;        // Содержимое full.front()
+    vector<T> tail;        // Хвостовой сегмент
+    int64_t tailId = -1;   // Файл сохраненного хвоста; -1 - еще не сохранялся
+    size_t headPos = 0;    // Уже извлеченные значения головного сегмента (tail, если full пуст)
+    size_t flushAt = segmentValues;
+    long long count = 0;
+    bool tailDirty = false;
+};
+
+// Стек из сегментов: в памяти верхний кусок top, ниже - полные сегменты lower.
+// Нижняя половина куска уходит на диск при 2 * segmentValues значений, чтобы
+// чередование SPUSH/SPOP на границе не перечитывало сегмент на каждой команде.
+// Оглавление: lower от дна и файл сохраненного куска topId.
+template <typename T>
+class SegmentedStack {
+public:
+    void push(const T& value) {
+        top.push_back(value);
+        topDirty = true;
+        count++;
+        if (top.size() >= spillAt) {
+            int64_t id = files.allocate();
+            if (files.write(id, top, segmentValues)) {
+                lower.push_back(id);
+                top.erase(top.begin(), top.begin() + segmentValues);
+                spillAt = 2 * segmentValues;
+            } else {
+                spillAt += segmentValues;  // Значения остаются в памяти, повтор через сегмент
+            }
+        }
+    }
+
+    // false, если стек пуст или нижний сегмент не прочитался (тогда length() > 0
+    // и сегмент остается в стеке)
+    bool pop(T& value) {
+        while (top.empty()) {
+            if (lower.empty()) {
+                return false;
+            }
+            if (!files.read(lower.back(), top)) {
+                cerr << "Unable to open file for reading!" << endl;
+                return false;
+            }
+            files.retire(lower.back());
+            lower.pop_back();
+        }
+        value = top.back();
+        top.pop_back();
+        topDirty = true;
+        count--;
+        return true;
+    }
+
+    long long length() const {
+        return count;
+    }
+
+    // Обход от вершины вниз; нижние сегменты читаются с диска
+    template <typename F>
+    void forEach(F visit) {
+        for (size_t i = top.size(); i > 0; --i) visit(top[i - 1]);
+        vector<T> segment;
+        for (size_t i = lower.size(); i > 0; --i) {
+            files.read(lower[i - 1], segment);
+            for (size_t j = segment.size(); j > 0; --j) visit(segment[j - 1]);
+        }
+    }
+
+    void readStack(ostream& out = cout) {
+        out << "Stack elements: ";
+        forEach([&](const T& value) { out << printed<T>(value) << " "; });
+        out << '\n';
+    }
+
+    void sprint(ostream& out = cout) {
+        readStack(out);
+    }
+
+    // Сохранение: верхний кусок (если менялся, под новым номером) и оглавление
+    void saveToFile(const string& filename, SnapshotFormat = SnapshotFormat::Compressed) {
+        files.open(filename);
+        if (topDirty || topId < 0) {
+            int64_t id = files.allocate();
+            if (!files.write(id, top)) {
+                return;
+            }
+            if (topId >= 0) {
+                files.retire(topId);
+            }
+            topId = id;
+            topDirty = false;
+        }
+        snapshot::Manifest manifest;
+        manifest.count = count;
+        manifest.ids = lower;
+        manifest.ids.push_back(topId);
+        files.commit(manifest);
+    }
+
+    void loadFromFile(const string& filename) {
+        files.open(filename);
+        snapshot::Manifest manifest;
+        if (!files.readManifest(manifest)) {  // Файл прежнего формата загружается целиком
+            if (!snapshot::load<T>(filename, [&](const T& value) { push(value); })) {
+                cerr << "Unable to open file for reading!" << endl;
+            }
+            return;
+        }
+        if (manifest.ids.empty()) {
+            cerr << "Unable to open file for reading!" << endl;
+            return;
+        }
+        topId = manifest.ids.back();
+        lower.assign(manifest.ids.begin(), manifest.ids.end() - 1);
+        count = manifest.count;
+        if (!files.read(topId, top)) {
+            cerr << "Unable to open file for reading!" << endl;
+            lower.clear();
+            topId = -1;
+            count = 0;
+        }
+    }
+
+private:
+    SegmentFiles<T> files;
+    vector<int64_t> lower;  // Номера полных сегментов от дна
+    vector<T> top;          // Верхние значения, от нижнего к вершине
+    int64_t topId = -1;     // Файл сохраненного куска; -1 - еще не сохранялся
+    size_t spillAt = 2 * segmentValues;
+    long long count = 0;
+    bool topDirty = false;
+};
+
+#endif
@@ -0,0 +1,534 @@
+#ifndef SERVER_H
+#define SERVER_H
+
+#include <cerrno>
+#include <charconv>
+#include <csignal>
+#include <cstdio>
+#include <cstring>
+#include <deque>
+#include <functional>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include "output.h"
+#include "parser.h"
+
+// Сетевой режим (--serve): epoll-сервер с протоколом, совместимым с RESP.
+// Структура загружается из файла один раз, команды клиентов выполняются в памяти,
+// снимок сохраняется по команде SAVE и при завершении (SIGINT/SIGTERM).
+//
+// Адрес: "6379" (127.0.0.1:6379), "host:port" или "unix:/path/to.sock".
+// Запросы принимаются как массивы bulk-строк RESP или как inline-строки,
+// поэтому работают и redis-cli/redis-benchmark, и обычный nc.
+// Конвейеризация: все полные запросы из прочитанного буфера выполняются подряд,
+// ответы копятся в буфере соединения и отправляются одним write.
+
+namespace server {
+
+const size_t maxBufferSize = 512 * 1024 * 1024;  // Предел на размер запроса и ответа
+const long maxArguments = 1024 * 1024;
+
+inline volatile sig_atomic_t stopRequested = 0;
+
+inline void requestStop(int) {
+    stopRequested = 1;
+}
+
+// Ответ, который еще может вычисляться в другом потоке (см. shard.h).
+// Хранит уже закодированные в RESP байты; remaining меняет только поток сервера
+struct PendingReply {
+    std::string resp;
+    int remaining = 0;  // Сколько исполнителей еще не ответили; 0 - ответ готов
+
+    virtual ~PendingReply() = default;
+};
+
+// Состояние одного клиентского соединения
+struct Connection {
+    int fd;
+    std::string input;    // Принятые, но еще не разобранные байты
+    std::string output;   // Ответы, ожидающие отправки
+    size_t outputSent;    // Сколько байт output уже отправлено
+    bool closing;         // Закрыть после отправки ответов (QUIT)
+    bool waitingWrite;    // Подписано ли соединение на EPOLLOUT
+    bool closed;          // Сокет закрыт, объект ждет завершения pending
+    bool queuedReady;     // Уже стоит в списке готовых соединений исполнителя
+    std::deque<PendingReply*> pending;  // Ответы конвейера в порядке запросов
+
+    explicit Connection(int socket)
+        : fd(socket), outputSent(0), closing(false), waitingWrite(false), closed(false), queuedReady(false) {}
+};
+
+// Буфер для очередного ответа с сохранением порядка конвейера:
+// пока впереди есть невычисленные ответы, новый ответ ставится за ними
+inline std::string& replyBuffer(Connection& conn) {
+    if (conn.pending.empty()) {
+        return conn.output;
+    }
+    PendingReply* ready = new PendingReply();
+    conn.pending.push_back(ready);
+    return ready->resp;
+}
+
+// Перенос готовых ответов из начала pending в буфер отправки
+inline void drainPending(Connection& conn) {
+    while (!conn.pending.empty() && conn.pending.front()->remaining == 0) {
+        conn.output += conn.pending.front()->resp;
+        delete conn.pending.front();
+        conn.pending.pop_front();
+    }
+}
+
+// Чтение строки "<число>\r\n" начиная с pos.
+// 1 - прочитано, 0 - данных пока не хватает, -1 - ошибка протокола
+inline int readNumberLine(std::string_view in, size_t& pos, long& value) {
+    size_t end = in.find("\r\n", pos);
+    if (end == std::string_view::npos) {
+        return in.size() - pos > 32 ? -1 : 0;
+    }
+    auto result = std::from_chars(in.data() + pos, in.data() + end, value);
+    if (result.ec != std::errc() || result.ptr != in.data() + end) {
+        return -1;
+    }
+    pos = end + 2;
+    return 1;
+}
+
+// Разбор одного запроса начиная с pos. Аргументы склеиваются через пробел в command,
+// чтобы их можно было передать в processCommand как обычную строку запроса.
+// 1 - запрос разобран, 0 - данных пока не хватает, -1 - ошибка протокола,
+// -2 - запрос пропущен: аргумент с пробельными символами после склейки распался бы на несколько,
+// а пустой исчез бы и сдвинул следующие аргументы
+inline int parseRequest(std::string_view in, size_t& pos, std::string& command) {
+    command.clear();
+    if (in[pos] != '*') {  // inline-команда до конца строки
+        size_t end = in.find('\n', pos);
+        if (end == std::string_view::npos) {
+            return in.size() - pos > 64 * 1024 ? -1 : 0;
+        }
+        size_t lineEnd = end;
+        if (lineEnd > pos && in[lineEnd - 1] == '\r') {
+            --lineEnd;
+        }
+        command.assign(in.substr(pos, lineEnd - pos));
+        pos = end + 1;
+        return 1;
+    }
+
+    size_t cur = pos + 1;
+    long count = 0;
+    bool splits = false;  // Какой-то аргумент пуст или содержит пробельные символы
+    int status = readNumberLine(in, cur, count);
+    if (status <= 0) {
+        return status;
+    }
+    if (count > maxArguments) {
+        return -1;
+    }
+    for (long i = 0; i < count; ++i) {
+        if (cur >= in.size()) {
+            return 0;
+        }
+        if (in[cur] != '$') {
+            return -1;
+        }
+        ++cur;
+        long length = 0;
+        status = readNumberLine(in, cur, length);
+        if (status <= 0) {
+            return status;
+        }
+        if (length < 0 || static_cast<size_t>(length) > maxBufferSize) {
+            return -1;
+        }
+        if (in.size() - cur < static_cast<size_t>(length) + 2) {
+            return 0;
+        }
+        if (in[cur + length] != '\r' || in[cur + length + 1] != '\n') {
+            return -1;
+        }
+        if (i > 0) {
+            command += ' ';
+        }
+        command.append(in.data() + cur, length);
+        splits = splits || length == 0;
+        for (long j = 0; j < length; ++j) {
+            splits = splits || Tokenizer::isSpace(in[cur + j]);
+        }
+        cur += length + 2;
+    }
+    pos = cur;
+    return splits ? -2 : 1;
+}
+
+// Текст без завершающих пробелов и переводов строк
+inline std::string_view trimRight(std::string_view text) {
+    while (!text.empty() && (text.back() == '\n' || text.back() == '\r' || text.back() == ' ')) {
+        text.remove_suffix(1);
+    }
+    return text;
+}
+
+// Ответ в формате RESP по выводу команды в формате format (output.h):
+//   text   - без завершающих пробелов; пустой вывод -> +OK, иначе bulk-строка
+//   quiet  - без последнего перевода строки; пустой вывод -> +OK, пустое значение -> $-1
+//   json   - bulk-строка без последнего перевода строки
+//   binary - bulk-строка с записью как есть: любой байт может быть частью числа
+inline void appendReply(std::string& out, std::string_view text, OutputFormat format = OutputFormat::Text) {
+    if (format == OutputFormat::Text) {
+        text = trimRight(text);
+    } else if (format != OutputFormat::Binary) {
+        if (format == OutputFormat::Quiet && text == "\n") {
+            out += "$-1\r\n";
+            return;
+        }
+        if (!text.empty() && text.back() == '\n') {
+            text.remove_suffix(1);
+        }
+    }
+    if (text.empty()) {
+        out += "+OK\r\n";
+        return;
+    }
+    out += '$';
+    out += std::to_string(text.size());
+    out += "\r\n";
+    out += text;
+    out += "\r\n";
+}
+
+// Ошибка RESP; переводы строк недопустимы, поэтому заменяются пробелами
+inline void appendError(std::string& out, std::string_view message) {
+    out += "-ERR ";
+    for (char ch : trimRight(message)) {
+        out += (ch == '\r' || ch == '\n') ? ' ' : ch;
+    }
+    out += "\r\n";
+}
+
+// Ответ на команду по ее выводу. В json и binary ошибка уже закодирована
+// в самом выводе ({"error":...}, запись 'E'), поэтому передается как обычный ответ
+inline void appendResult(std::string& out, bool known, std::string_view text, OutputFormat format = OutputFormat::Text) {
+    if (known || format == OutputFormat::Json || format == OutputFormat::Binary) {
+        appendReply(out, text, format);
+    } else {
+        appendError(out, text);
+    }
+}
+
+inline bool setNonBlocking(int fd) {
+    int flags = fcntl(fd, F_GETFL, 0);
+    return flags >= 0 && fcntl(fd, F_SETFL, flags | O_NONBLOCK) == 0;
+}
+
+// Открытие слушающего сокета по адресу из --serve. Возвращает -1 при ошибке
+inline int listenOn(const std::string& address) {
+    int fd = -1;
+    if (address.rfind("unix:", 0) == 0) {
+        std::string path = address.substr(5);
+        sockaddr_un addr{};
+        if (path.empty() || path.size() >= sizeof(addr.sun_path)) {
+            std::cerr << "Invalid socket path: " << path << std::endl;
+            return -1;
+        }
+        addr.sun_family = AF_UNIX;
+        std::memcpy(addr.sun_path, path.c_str(), path.size() + 1);
+        fd = socket(AF_UNIX, SOCK_STREAM, 0);
+        unlink(path.c_str());  // Сокет мог остаться от предыдущего запуска
+        if (fd < 0 || bind(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0) {
+            perror("bind");
+            if (fd >= 0) close(fd);
+            return -1;
+        }
+    } else {
+        std::string host = "127.0.0.1";
+        std::string port = address;
+        size_t colon = address.rfind(':');
+        if (colon != std::string::npos) {
+            host = address.substr(0, colon);
+            port = address.substr(colon + 1);
+        }
+        int portNumber = 0;
+        auto result = std::from_chars(port.data(), port.data() + port.size(), portNumber);
+        sockaddr_in addr{};
+        addr.sin_family = AF_INET;
+        addr.sin_port = htons(static_cast<uint16_t>(portNumber));
+        if (result.ec != std::errc() || portNumber <= 0 || portNumber > 65535 ||
+            inet_pton(AF_INET, host.c_str(), &addr.sin_addr) != 1) {
+            std::cerr << "Invalid address: " << address << std::endl;
+            return -1;
+        }
+        fd = socket(AF_INET, SOCK_STREAM, 0);
+        int reuse = 1;
+        if (fd < 0 || setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse)) != 0 ||
+            bind(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0) {
+            perror("bind");
+            if (fd >= 0) close(fd);
+            return -1;
+        }
+    }
+    if (listen(fd, SOMAXCONN) != 0 || !setNonBlocking(fd)) {
+        perror("listen");
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+// Отправка накопленных ответов. false - соединение нужно закрыть
+inline bool flushOutput(Connection& conn) {
+    while (conn.outputSent < conn.output.size()) {
+        ssize_t written = write(conn.fd, conn.output.data() + conn.outputSent,
+                                conn.output.size() - conn.outputSent);
+        if (written < 0) {
+            if (errno == EINTR) continue;
+            if (errno == EAGAIN || errno == EWOULDBLOCK) return true;
+            return false;
+        }
+        conn.outputSent += static_cast<size_t>(written);
+    }
+    conn.output.clear();
+    conn.outputSent = 0;
+    return !conn.closing || !conn.pending.empty();  // QUIT закрывает после всех ответов
+}
+
+// Исполнитель, выполняющий команды прямо в потоке сервера.
+// handle(command, out) пишет текстовый ответ в out и возвращает false для неизвестной команды;
+// save() сохраняет снимок в файл
+template <typename Handler>
+class InlineExecutor {
+public:
+    InlineExecutor(Handler handler, std::function<void()> saver, OutputFormat outputFormat)
+        : handle(handler), save(saver), format(outputFormat) {}
+
+    void execute(Connection& conn, std::string_view command) {
+        capture.str("");
+        capture.clear();
+        bool known = handle(command, capture);
+        appendResult(replyBuffer(conn), known, capture.str(), format);
+    }
+
+    void snapshot(Connection& conn) {
+        save();
+        replyBuffer(conn) += "+OK\r\n";
+    }
+
+    int completionFd() const { return -1; }      // Асинхронных ответов нет
+    void collect() {}
+    void dispatch() {}
+    std::vector<Connection*>& readyConnections() { return ready; }
+    void shutdown() { save(); }
+
+private:
+    Handler handle;
+    std::function<void()> save;
+    OutputFormat format;         // Формат вывода команд (--output), от него зависит кодирование ответа
+    std::ostringstream capture;  // Текстовый вывод текущей команды
+    std::vector<Connection*> ready;
+};
+
+// Основной цикл сервера над произвольным исполнителем команд.
+// Исполнитель отвечает сразу (через replyBuffer) или ставит PendingReply в conn.pending
+// и позже сообщает о готовности через completionFd()/collect()/readyConnections()
+template <typename Executor>
+int serve(const std::string& address, Executor& executor) {
+    int listenFd = listenOn(address);
+    if (listenFd < 0) {
+        return 1;
+    }
+    int epollFd = epoll_create1(0);
+    epoll_event event{};
+    event.events = EPOLLIN;
+    event.data.fd = listenFd;
+    epoll_ctl(epollFd, EPOLL_CTL_ADD, listenFd, &event);
+    int completionFd = executor.completionFd();
+    if (completionFd >= 0) {
+        epoll_event completionEvent{};
+        completionEvent.events = EPOLLIN;
+        completionEvent.data.fd = completionFd;
+        epoll_ctl(epollFd, EPOLL_CTL_ADD, completionFd, &completionEvent);
+    }
+
+    struct sigaction action {};
+    action.sa_handler = requestStop;  // Без SA_RESTART, чтобы epoll_wait прервался
+    sigaction(SIGINT, &action, nullptr);
+    sigaction(SIGTERM, &action, nullptr);
+    signal(SIGPIPE, SIG_IGN);
+
+    std::cerr << "Listening on " << address << std::endl;
+
+    std::vector<Connection*> connections;  // Индекс - дескриптор сокета
+    std::string command;
+    epoll_event events[128];
+
+    // Сокет закрывается сразу, а объект удаляется, когда исполнители вернут все его ответы
+    auto closeConnection = [&](Connection* conn) {
+        epoll_ctl(epollFd, EPOLL_CTL_DEL, conn->fd, nullptr);
+        close(conn->fd);
+        connections[conn->fd] = nullptr;
+        conn->closed = true;
+        if (conn->pending.empty() && !conn->queuedReady) {
+            delete conn;
+        }
+    };
+
+    // Отправка ответов и подписка на EPOLLOUT, если сокет принял не все
+    auto flushConnection = [&](Connection* conn, bool alive) {
+        if (!flushOutput(*conn) || (!alive && conn->output.empty())) {
+            closeConnection(conn);
+            return;
+        }
+        bool needWrite = !conn->output.empty();
+        if (needWrite != conn->waitingWrite) {
+            epoll_event update{};
+            update.events = needWrite ? (EPOLLIN | EPOLLOUT) : EPOLLIN;
+            update.data.fd = conn->fd;
+            epoll_ctl(epollFd, EPOLL_CTL_MOD, conn->fd, &update);
+            conn->waitingWrite = needWrite;
+        }
+    };
+
+    // Выполнение всех полных запросов из входного буфера
+    auto processInput = [&](Connection& conn) {
+        size_t pos = 0;
+        while (pos < conn.input.size() && !conn.closing) {
+            int status = parseRequest(conn.input, pos, command);
+            if (status == 0) break;
+            if (status == -2) {  // Соединение остается открытым: отвергается только этот запрос
+                appendError(replyBuffer(conn), "Empty arguments or arguments with whitespace are not supported");
+                continue;
+            }
+            if (status < 0) {
+                appendError(replyBuffer(conn), "Protocol error");
+                conn.closing = true;
+                break;
+            }
+            Tokenizer tokens(command);
+            std::string_view cmd = tokens.next();
+            if (cmd.empty()) {
+                continue;
+            } else if (cmd == "PING") {
+                replyBuffer(conn) += "+PONG\r\n";
+            } else if (cmd == "QUIT") {
+                replyBuffer(conn) += "+OK\r\n";
+                conn.closing = true;
+            } else if (cmd == "SAVE") {
+                executor.snapshot(conn);
+            } else if (cmd == "COMMAND" || cmd == "CONFIG") {
+                replyBuffer(conn) += "*0\r\n";  // Служебные запросы redis-cli и redis-benchmark
+            } else {
+                executor.execute(conn, command);
+            }
+        }
+        conn.input.erase(0, pos);
+    };
+
+    while (!stopRequested) {
+        int count = epoll_wait(epollFd, events, 128, -1);
+        if (count < 0) {
+            if (errno == EINTR) continue;
+            perror("epoll_wait");
+            break;
+        }
+        for (int i = 0; i < count; ++i) {
+            int fd = events[i].data.fd;
+            if (fd == listenFd) {
+                int client;
+                while ((client = accept4(listenFd, nullptr, nullptr, SOCK_NONBLOCK)) >= 0) {
+                    int noDelay = 1;
+                    setsockopt(client, IPPROTO_TCP, TCP_NODELAY, &noDelay, sizeof(noDelay));
+                    if (static_cast<size_t>(client) >= connections.size()) {
+                        connections.resize(client + 1, nullptr);
+                    }
+                    connections[client] = new Connection(client);
+                    epoll_event clientEvent{};
+                    clientEvent.events = EPOLLIN;
+                    clientEvent.data.fd = client;
+                    epoll_ctl(epollFd, EPOLL_CTL_ADD, client, &clientEvent);
+                }
+                continue;
+            }
+            if (fd == completionFd) {
+                executor.collect();
+                continue;
+            }
+
+            Connection* conn = connections[fd];
+            if (conn == nullptr) continue;
+            bool alive = true;
+
+            if (events[i].events & (EPOLLIN | EPOLLHUP | EPOLLERR)) {
+                char buffer[64 * 1024];
+                while (true) {
+                    ssize_t received = read(fd, buffer, sizeof(buffer));
+                    if (received > 0) {
+                        conn->input.append(buffer, received);
+                        if (conn->input.size() > maxBufferSize) {
+                            alive = false;
+                            break;
+                        }
+                        continue;
+                    }
+                    if (received < 0 && errno == EINTR) continue;
+                    if (received == 0 || (errno != EAGAIN && errno != EWOULDBLOCK)) {
+                        alive = false;  // Клиент закрыл соединение или ошибка чтения
+                    }
+                    break;
+                }
+                processInput(*conn);
+            }
+            flushConnection(conn, alive);
+        }
+
+        executor.dispatch();  // Передача накопленных команд исполнителям одним пакетом
+
+        std::vector<Connection*>& ready = executor.readyConnections();
+        for (Connection* conn : ready) {
+            conn->queuedReady = false;
+            drainPending(*conn);
+            if (!conn->closed) {
+                flushConnection(conn, true);
+            } else if (conn->pending.empty()) {
+                delete conn;
+            }
+        }
+        ready.clear();
+    }
+
+    for (Connection* conn : connections) {
+        if (conn != nullptr) closeConnection(conn);
+    }
+    close(listenFd);
+    close(epollFd);
+    if (address.rfind("unix:", 0) == 0) {
+        unlink(address.substr(5).c_str());
+    }
+    executor.shutdown();
+    std::cerr << "Server stopped, data saved" << std::endl;
+    return 0;
+}
+
+// Однопоточный сервер: команды выполняются handle прямо в цикле epoll;
+// format - формат, в котором handle пишет ответы
+template <typename Handler>
+int runServer(const std::string& address, Handler handle, const std::function<void()>& save, OutputFormat format) {
+    InlineExecutor<Handler> executor(handle, save, format);
+    return serve(address, executor);
+}
+
+}  // namespace server
+
+#endif
@@ -0,0 +1,383 @@
+#ifndef SHARD_H
+#define SHARD_H
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include <pthread.h>
+#include <sched.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
+
+#include "metrics.h"
+#include "output.h"
+#include "server.h"
+
+// Шардированный режим сервера (--shards N): пространство ключей делится между N шардами,
+// каждым шардом владеет свой рабочий поток, закрепленный за ядром процессора.
+// Поток сервера только разбирает запросы и маршрутизирует их по ключу через
+// lock-free очереди "один писатель - один читатель", поэтому структуры шардов
+// не требуют блокировок. Новые узлы шарда выделяются в его потоке, то есть в отдельной
+// арене malloc; снимок загружается основным потоком до start().
+//
+// Traits описывает структуру данных шарда:
+//   static bool execute(Engine&, string_view command, ostream& out, OutputFormat format)
+//                                                                    - выполнение команды
+//   static int route(string_view command, int shardCount)           - номер шарда, -1 (все шарды)
+//                                                                      или -2 (команда делится split)
+//   static void split(string_view command, int shardCount, vector<string>& commands)
+//                                                                    - команды шардов для многоключевой
+//                                                                      команды; пустая - шард не участвует
+//   static bool merge(string_view command, const vector<string>& parts, ostream& out, OutputFormat format)
+//                                                                    - один ответ из ответов шардов
+//                                                                      (в формате binary; пустой - шард
+//                                                                      не участвовал) для -1 и -2
+//   static void write(const Engine&, ostream& out)                    - запись снимка шарда
+
+// Кольцевой буфер для одного производителя и одного потребителя
+template <typename T>
+class SpscQueue {
+public:
+    explicit SpscQueue(size_t capacity) {
+        size_t size = 1;
+        while (size < capacity) size <<= 1;
+        mask = size - 1;
+        items = new T[size];
+    }
+
+    ~SpscQueue() {
+        delete[] items;
+    }
+
+    SpscQueue(const SpscQueue&) = delete;
+    SpscQueue& operator=(const SpscQueue&) = delete;
+
+    // Вызывается только производителем; false, если очередь заполнена
+    bool push(const T& item) {
+        size_t tail = tailIndex.load(std::memory_order_relaxed);
+        if (tail - cachedHead > mask) {
+            cachedHead = headIndex.load(std::memory_order_acquire);
+            if (tail - cachedHead > mask) return false;
+        }
+        items[tail & mask] = item;
+        tailIndex.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Вызывается только потребителем; false, если очередь пуста
+    bool pop(T& item) {
+        size_t head = headIndex.load(std::memory_order_relaxed);
+        if (head == cachedTail) {
+            cachedTail = tailIndex.load(std::memory_order_acquire);
+            if (head == cachedTail) return false;
+        }
+        item = items[head & mask];
+        headIndex.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    bool empty() const {
+        return headIndex.load(std::memory_order_acquire) == tailIndex.load(std::memory_order_acquire);
+    }
+
+private:
+    // Индексы производителя и потребителя разнесены по разным кеш-линиям
+    alignas(64) std::atomic<size_t> headIndex{0};
+    size_t cachedTail = 0;  // Копия tailIndex у потребителя
+    alignas(64) std::atomic<size_t> tailIndex{0};
+    size_t cachedHead = 0;  // Копия headIndex у производителя
+    alignas(64) size_t mask = 0;
+    T* items = nullptr;
+};
+
+// Номер шарда для ключа (FNV-1a; не зависит от хеш-функции самой структуры)
+inline int keyShard(std::string_view key, int shardCount) {
+    uint64_t hash = 1469598103934665603ULL;
+    for (char ch : key) {
+        hash = (hash ^ static_cast<unsigned char>(ch)) * 1099511628211ULL;
+    }
+    return static_cast<int>(hash % static_cast<uint64_t>(shardCount));
+}
+
+// Закрепление потока за ядром; без эффекта, если ядер меньше, чем номер
+inline void pinToCpu(std::thread& thread, int cpu) {
+    unsigned cpuCount = std::thread::hardware_concurrency();
+    if (cpuCount == 0) return;
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(cpu % cpuCount, &set);
+    pthread_setaffinity_np(thread.native_handle(), sizeof(set), &set);
+}
+
+template <typename Engine, typename Traits>
+class ShardedExecutor {
+public:
+    ShardedExecutor(int shardCount, const std::string& snapshotFile, OutputFormat outputFormat)
+        : filename(snapshotFile), format(outputFormat), doneFd(eventfd(0, EFD_NONBLOCK)) {
+        for (int i = 0; i < shardCount; ++i) {
+            shards.push_back(new Shard());
+        }
+    }
+
+    ~ShardedExecutor() {
+        stopWorkers();
+        for (Shard* shard : shards) {
+            delete shard;
+        }
+        close(doneFd);
+    }
+
+    int shardCount() const { return static_cast<int>(shards.size()); }
+
+    // Структура шарда; до start() к ней можно обращаться из основного потока (загрузка)
+    Engine& engine(int index) { return shards[index]->engine; }
+
+    // Запуск рабочих потоков; ядро 0 остается потоку сервера
+    void start() {
+        for (size_t i = 0; i < shards.size(); ++i) {
+            Shard* shard = shards[i];
+            shard->worker = std::thread([this, shard, i]() { run(*shard, static_cast<int>(i)); });
+            pinToCpu(shard->worker, static_cast<int>(i) + 1);
+        }
+    }
+
+    void execute(server::Connection& conn, std::string_view command) {
+        int target = Traits::route(command, shardCount());
+        if (target == -2) {
+            scatter(conn, command);
+            return;
+        }
+        Request* request = newRequest(conn, command, target < 0);
+        if (target < 0) {
+            for (int i = 0; i < shardCount(); ++i) submit(i, request);
+        } else {
+            submit(target, request);
+        }
+    }
+
+    // Многоключевая команда: шарды выполняют свои части, ответы склеиваются по порядку шардов
+    void scatter(server::Connection& conn, std::string_view command) {
+        std::vector<std::string> commands(shardCount());
+        Traits::split(command, shardCount(), commands);
+        Request* request = newRequest(conn, command, true);
+        request->remaining = 0;
+        for (const std::string& part : commands) {
+            if (!part.empty()) request->remaining++;
+        }
+        request->commands = std::move(commands);
+        for (int i = 0; i < shardCount(); ++i) {
+            if (!request->commands[i].empty()) submit(i, request);
+        }
+    }
+
+    // SAVE: каждый шард сериализует себя в своем потоке, файл пишется после ответа всех
+    void snapshot(server::Connection& conn) {
+        Request* request = newRequest(conn, std::string_view(), true);
+        request->snapshot = true;
+        for (int i = 0; i < shardCount(); ++i) submit(i, request);
+    }
+
+    int completionFd() const { return doneFd; }
+
+    // Разбор выполненных запросов из очередей шардов
+    void collect() {
+        uint64_t counter;
+        while (read(doneFd, &counter, sizeof(counter)) > 0) {}
+        Task task;
+        for (Shard* shard : shards) {
+            while (shard->outbound.pop(task)) {
+                complete(task.request);
+            }
+        }
+    }
+
+    // Пробуждение шардов, получивших новые команды с прошлого вызова
+    void dispatch() {
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        for (Shard* shard : shards) {
+            if (shard->submitted && shard->sleeping.exchange(false)) {
+                uint64_t one = 1;
+                (void)!write(shard->wakeFd, &one, sizeof(one));
+            }
+            shard->submitted = false;
+        }
+    }
+
+    std::vector<server::Connection*>& readyConnections() { return ready; }
+
+    // Остановка шардов и запись итогового снимка из основного потока
+    void shutdown() {
+        stopWorkers();
+        std::ofstream outFile(filename);
+        if (!outFile.is_open()) {
+            std::cerr << "Unable to open file for writing!" << std::endl;
+            return;
+        }
+        for (Shard* shard : shards) {
+            Traits::write(shard->engine, outFile);
+        }
+    }
+
+private:
+    // Запрос к одному или всем шардам
+    struct Request : server::PendingReply {
+        server::Connection* conn = nullptr;
+        std::string command;
+        bool broadcast = false;
+        bool snapshot = false;
+        std::vector<std::string> parts;  // Ответы шардов при широковещательном запросе
+        std::vector<std::string> commands;  // Команды шардов при разделенном запросе (scatter)
+    };
+
+    struct Task {
+        Request* request = nullptr;  // nullptr - сигнал остановки потока
+        int shard = 0;
+    };
+
+    struct Shard {
+        Engine engine;
+        SpscQueue<Task> inbound{65536};   // Поток сервера -> шард
+        SpscQueue<Task> outbound{65536};  // Шард -> поток сервера
+        std::thread worker;
+        int wakeFd = eventfd(0, 0);
+        alignas(64) std::atomic<bool> sleeping{false};
+        std::atomic<bool> stopped{false};
+        bool submitted = false;  // Есть непереданные в dispatch() задачи
+
+        ~Shard() { close(wakeFd); }
+    };
+
+    Request* newRequest(server::Connection& conn, std::string_view command, bool broadcast) {
+        Request* request = new Request();
+        request->conn = &conn;
+        request->command.assign(command);
+        request->broadcast = broadcast;
+        request->remaining = broadcast ? shardCount() : 1;
+        if (broadcast) {
+            request->parts.resize(shardCount());
+        }
+        conn.pending.push_back(request);
+        return request;
+    }
+
+    void submit(int index, Request* request) {
+        Shard* shard = shards[index];
+        Task task{request, index};
+        while (!shard->inbound.push(task)) {
+            // Очередь шарда заполнена: будим его и разгружаем ответы, чтобы он не встал на outbound
+            shard->submitted = true;
+            dispatch();
+            collect();
+            std::this_thread::yield();
+        }
+        shard->submitted = true;
+    }
+
+    void complete(Request* request) {
+        if (--request->remaining > 0) return;
+        if (request->snapshot) {
+            std::ofstream outFile(filename);
+            if (outFile.is_open()) {
+                for (const std::string& part : request->parts) outFile << part;
+                request->resp = "+OK\r\n";
+            } else {
+                server::appendError(request->resp, "Unable to open file for writing!");
+            }
+        } else if (request->broadcast) {  // Ответы шардов собираются в один ответ формата format
+            std::ostringstream merged;
+            bool known = Traits::merge(request->command, request->parts, merged, format);
+            server::appendResult(request->resp, known, merged.str(), format);
+        }
+        request->parts.clear();
+        server::Connection* conn = request->conn;
+        if (!conn->queuedReady) {
+            conn->queuedReady = true;
+            ready.push_back(conn);
+        }
+    }
+
+    // Цикл рабочего потока: выполняет команды пакетами, спит на eventfd, когда очередь пуста
+    void run(Shard& shard, int index) {
+        metrics.shard = index;  // Метрики потока помечаются номером шарда
+        std::ostringstream capture;
+        Task task;
+        while (true) {
+            bool worked = false;
+            while (shard.inbound.pop(task)) {
+                if (task.request == nullptr) {
+                    shard.stopped.store(true);
+                    return;
+                }
+                Request* request = task.request;
+                capture.str("");
+                capture.clear();
+                if (request->snapshot) {
+                    auto start = std::chrono::steady_clock::now();
+                    Traits::write(shard.engine, capture);
+                    request->parts[index] = capture.str();
+                    metrics.recordSave(Metrics::since(start));  // Время сериализации шарда
+                } else if (request->broadcast) {
+                    const std::string& command = request->commands.empty() ? request->command : request->commands[index];
+                    Traits::execute(shard.engine, command, capture, OutputFormat::Binary);
+                    request->parts[index] = capture.str();
+                } else {
+                    bool known = Traits::execute(shard.engine, request->command, capture, format);
+                    server::appendResult(request->resp, known, capture.str(), format);
+                }
+                while (!shard.outbound.push(task)) {
+                    std::this_thread::yield();
+                }
+                worked = true;
+            }
+            if (worked) {
+                uint64_t one = 1;
+                (void)!write(doneFd, &one, sizeof(one));
+                continue;
+            }
+            shard.sleeping.store(true);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            if (!shard.inbound.empty()) {
+                shard.sleeping.store(false);
+                continue;
+            }
+            uint64_t counter;
+            (void)!read(shard.wakeFd, &counter, sizeof(counter));
+        }
+    }
+
+    void stopWorkers() {
+        for (Shard* shard : shards) {
+            if (!shard->worker.joinable()) continue;
+            Task task;
+            while (!shard->inbound.push(Task())) {
+                while (shard->outbound.pop(task)) complete(task.request);
+                std::this_thread::yield();
+            }
+            uint64_t one = 1;
+            (void)!write(shard->wakeFd, &one, sizeof(one));
+            while (!shard->stopped.load()) {  // Разгружаем ответы, иначе шард может встать на outbound
+                while (shard->outbound.pop(task)) complete(task.request);
+                std::this_thread::yield();
+            }
+            while (shard->outbound.pop(task)) complete(task.request);
+            shard->worker.join();
+        }
+    }
+
+    std::string filename;
+    OutputFormat format;  // Формат ответов шардов (--output), см. server::appendReply
+    int doneFd;
+    std::vector<Shard*> shards;
+    std::vector<server::Connection*> ready;
+};
+
+#endif
@@ -0,0 +1,323 @@
+#ifndef SNAPSHOT_H
+#define SNAPSHOT_H
+
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+#include "traits.h"
+
+// Сжатый формат файла данных для целочисленных структур (--compress).
+// После сигнатуры "DBZ1" идут блоки: u32 число значений, u32 длина данных (little-endian)
+// и данные - разности соседних значений в zigzag-кодировании, записанные varint
+// (7 бит на байт). Разность считается через границы блоков, так что возрастающие
+// и близкие значения занимают 1-2 байта вместо 8-20 в текстовом формате.
+// Чтение идет блок за блоком: в памяти не больше одного блока.
+// Загрузка определяет формат по сигнатуре, так что текстовые файлы читаются как прежде.
+// Сегментированный файл (оглавление, см. segment.h) читается и перезаписывается любой
+// структурой: load читает значения из сегментов, save после записи удаляет сегменты.
+
+enum class SnapshotFormat { Text, Compressed };
+
+// Разбор и удаление из argv флага --compress
+inline void takeSnapshotFlags(int& argc, char* argv[], SnapshotFormat& format) {
+    int kept = 1;
+    for (int i = 1; i < argc; ++i) {
+        if (std::string_view(argv[i]) == "--compress") {
+            format = SnapshotFormat::Compressed;
+        } else {
+            argv[kept++] = argv[i];
+        }
+    }
+    argc = kept;
+}
+
+namespace snapshot {
+
+constexpr char magic[4] = {'D', 'B', 'Z', '1'};
+constexpr uint32_t blockValues = 65536;  // Значений в блоке
+constexpr uint32_t maxVarintBytes = 10;  // Наибольшая длина varint для 64-битного значения
+
+// Сжатие доступно только целым типам
+template <typename T>
+constexpr bool compressible = std::is_integral_v<T>;
+
+// Файл начинается с сигнатуры сжатого формата; позиция чтения остается в начале
+inline bool isCompressed(std::istream& in) {
+    char header[sizeof(magic)];
+    in.read(header, sizeof(header));
+    bool found = in.gcount() == sizeof(header) && std::memcmp(header, magic, sizeof(magic)) == 0;
+    in.clear();
+    in.seekg(0);
+    return found;
+}
+
+inline void writeU32(std::ostream& out, uint32_t value) {
+    unsigned char buffer[4];
+    for (int i = 0; i < 4; ++i) {
+        buffer[i] = static_cast<unsigned char>(value >> (8 * i));
+    }
+    out.write(reinterpret_cast<const char*>(buffer), sizeof(buffer));
+}
+
+inline bool readU32(std::istream& in, uint32_t& value) {
+    unsigned char buffer[4];
+    if (!in.read(reinterpret_cast<char*>(buffer), sizeof(buffer))) {
+        return false;
+    }
+    value = 0;
+    for (int i = 0; i < 4; ++i) {
+        value |= static_cast<uint32_t>(buffer[i]) << (8 * i);
+    }
+    return true;
+}
+
+template <typename T>
+class Writer {
+public:
+    explicit Writer(std::ostream& stream) : out(stream) {
+        out.write(magic, sizeof(magic));
+        data.reserve(blockValues * 2);
+    }
+
+    ~Writer() {
+        flush();
+    }
+
+    void put(T value) {
+        uint64_t delta = static_cast<uint64_t>(static_cast<int64_t>(value)) - static_cast<uint64_t>(static_cast<int64_t>(previous));
+        uint64_t zigzag = (delta << 1) ^ static_cast<uint64_t>(static_cast<int64_t>(delta) >> 63);
+        while (zigzag >= 0x80) {
+            data.push_back(static_cast<unsigned char>(zigzag | 0x80));
+            zigzag >>= 7;
+        }
+        data.push_back(static_cast<unsigned char>(zigzag));
+        previous = value;
+        if (++count == blockValues) {
+            flush();
+        }
+    }
+
+    void flush() {
+        if (count == 0) {
+            return;
+        }
+        writeU32(out, count);
+        writeU32(out, static_cast<uint32_t>(data.size()));
+        out.write(reinterpret_cast<const char*>(data.data()), static_cast<std::streamsize>(data.size()));
+        data.clear();
+        count = 0;
+    }
+
+private:
+    std::ostream& out;
+    std::vector<unsigned char> data;  // Данные текущего блока
+    uint32_t count = 0;               // Значений в текущем блоке
+    T previous = 0;
+};
+
+// Чтение после isCompressed; get возвращает false в конце файла или на поврежденном блоке
+template <typename T>
+class Reader {
+public:
+    explicit Reader(std::istream& stream) : in(stream) {
+        in.seekg(sizeof(magic));
+    }
+
+    bool get(T& value) {
+        if (remaining == 0 && !nextBlock()) {
+            return false;
+        }
+        uint64_t zigzag = 0;
+        for (int shift = 0;; shift += 7) {
+            if (position == data.size() || shift > 63) {
+                remaining = 0;  // Блок оборван: дальше не читаем
+                data.clear();
+                in.setstate(std::ios::failbit);
+                return false;
+            }
+            unsigned char byte = data[position++];
+            zigzag |= static_cast<uint64_t>(byte & 0x7f) << shift;
+            if ((byte & 0x80) == 0) {
+                break;
+            }
+        }
+        uint64_t delta = (zigzag >> 1) ^ (~(zigzag & 1) + 1);
+        previous = static_cast<T>(static_cast<uint64_t>(static_cast<int64_t>(previous)) + delta);
+        value = previous;
+        remaining--;
+        return true;
+    }
+
+private:
+    bool nextBlock() {
+        uint32_t size = 0;
+        if (!readU32(in, remaining) || !readU32(in, size)) {
+            remaining = 0;
+            return false;
+        }
+        if (remaining > blockValues || size > remaining * maxVarintBytes) {  // Заголовок поврежден: не выделяем память по нему
+            remaining = 0;
+            in.setstate(std::ios::failbit);
+            return false;
+        }
+        data.resize(size);
+        position = 0;
+        if (!in.read(reinterpret_cast<char*>(data.data()), size)) {
+            remaining = 0;
+            return false;
+        }
+        return remaining > 0 || nextBlock();
+    }
+
+    std::istream& in;
+    std::vector<unsigned char> data;  // Данные текущего блока
+    size_t position = 0;
+    uint32_t remaining = 0;           // Непрочитанных значений в блоке
+    T previous = 0;
+};
+
+// Оглавление сегментированного файла данных: строка
+// "SEGMENTS следующий_номер смещение число_значений n номер_1 ... номер_n".
+// Значения лежат в файлах filename.номер (сжатый формат) в порядке номеров списка;
+// первые "смещение" значений первого сегмента уже извлечены
+struct Manifest {
+    int64_t nextId = 0;  // Номер для следующего нового файла сегмента
+    int64_t headPos = 0;
+    int64_t count = 0;
+    std::vector<int64_t> ids;
+};
+
+inline std::string segmentPath(const std::string& filename, int64_t id) {
+    return filename + "." + std::to_string(id);
+}
+
+// Чтение оглавления; false, если файла нет или это не оглавление
+inline bool readManifest(const std::string& filename, Manifest& manifest) {
+    std::ifstream inFile(filename, std::ios::binary);
+    char tag[9];
+    if (!inFile.read(tag, sizeof(tag)) || std::memcmp(tag, "SEGMENTS ", sizeof(tag)) != 0) {
+        return false;
+    }
+    size_t n = 0;
+    if (!(inFile >> manifest.nextId >> manifest.headPos >> manifest.count >> n)) {
+        return false;
+    }
+    manifest.ids.assign(n, 0);
+    for (int64_t& id : manifest.ids) {
+        if (!(inFile >> id)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Запись оглавления в поток
+inline void writeManifest(std::ostream& out, const Manifest& manifest) {
+    out << "SEGMENTS " << manifest.nextId << ' ' << manifest.headPos << ' ' << manifest.count << ' '
+        << manifest.ids.size();
+    for (int64_t id : manifest.ids) {
+        out << ' ' << id;
+    }
+    out << '\n';
+}
+
+// Удаление файлов сегментов оглавления (после перезаписи файла данных другим форматом)
+inline void removeSegments(const std::string& filename, const Manifest& manifest) {
+    for (int64_t id : manifest.ids) {
+        std::remove(segmentPath(filename, id).c_str());
+    }
+}
+
+// Чтение текстового или сжатого файла значений (без оглавления)
+template <typename T, typename Add>
+bool loadValues(const std::string& filename, Add add) {
+    std::ifstream inFile(filename, std::ios::binary);
+    if (!inFile.is_open()) {
+        return false;
+    }
+    T value;
+    if constexpr (compressible<T>) {
+        if (isCompressed(inFile)) {
+            Reader<T> reader(inFile);
+            while (reader.get(value)) {
+                add(value);
+            }
+            return true;
+        }
+    }
+    while (ValueTraits<T>::read(inFile, value)) {
+        add(value);
+    }
+    return true;
+}
+
+// Чтение значений сегментированного файла по порядку; false, если сегмент не открылся
+template <typename T, typename Add>
+bool loadSegments(const std::string& filename, const Manifest& manifest, Add add) {
+    int64_t skip = manifest.headPos;
+    int64_t left = manifest.count;
+    for (int64_t id : manifest.ids) {
+        bool opened = loadValues<T>(segmentPath(filename, id), [&](const T& value) {
+            if (skip > 0) {
+                skip--;
+            } else if (left > 0) {
+                left--;
+                add(value);
+            }
+        });
+        if (!opened) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Запись файла данных: each(put) вызывает put(value) для значений по порядку.
+// Сжатый формат - только для целых T, остальные пишутся текстом. false, если файл не открылся
+template <typename T, typename Each>
+bool save(const std::string& filename, SnapshotFormat format, Each each) {
+    Manifest previous;
+    bool segmented = readManifest(filename, previous);  // Файл заменяет оглавление: сегменты больше не нужны
+    std::ofstream outFile(filename, std::ios::binary);
+    if (!outFile.is_open()) {
+        return false;
+    }
+    bool compressed = false;
+    if constexpr (compressible<T>) {
+        if (format == SnapshotFormat::Compressed) {
+            Writer<T> writer(outFile);
+            each([&](const T& value) { writer.put(value); });
+            compressed = true;
+        }
+    }
+    if (!compressed) {
+        each([&](const T& value) { outFile << printed<T>(value) << '\n'; });
+    }
+    outFile.close();
+    if (segmented && outFile) {
+        removeSegments(filename, previous);
+    }
+    return true;
+}
+
+// Чтение файла данных любого формата: add(value) для значений по порядку записи.
+// false, если файл не открылся
+template <typename T, typename Add>
+bool load(const std::string& filename, Add add) {
+    Manifest manifest;
+    if (readManifest(filename, manifest)) {
+        return loadSegments<T>(filename, manifest, add);
+    }
+    return loadValues<T>(filename, add);
+}
+
+}  // namespace snapshot
+
+#endif
@@ -1,159 +1,122 @@
+#include <chrono>
 #include <iostream>
 #include <fstream>
 #include <string>
-#include <sstream>
+#include <string_view>
 
-using namespace std;
-
-// Структура ноды для стека 
-struct Node {
-    int data;       // Данные ноды
-    Node* next;     // Указатель на следующий элемент
-
-    Node(int value) : data(value), next(nullptr) {}
-};
-
-// Класс Stack для реализации стека
-class Stack {
-public:
-    Stack() : top(nullptr), size(0) {}
+#include "stack.h"
+#include "batch.h"
+#include "metrics.h"
+#include "output.h"
+#include "parser.h"
+#include "segment.h"
+#include "server.h"
 
-    ~Stack() {
-        clear();  // Очистка памяти при удалении стека
-    }
-
-    // Добавление элемента на вершину стека
-    void push(int value) {
-        Node* newNode = new Node(value);
-        newNode->next = top;  // Устанавливаем указатель на текущую вершину
-        top = newNode;        // Вершина теперь указывает на новый элемент
-        size++;
-    }
-
-    // Удаление элемента с вершины стека
-    void pop() {
-        if (isEmpty()) {
-            cout << "Stack is empty!" << endl;
-            return;
-        }
-        Node* temp = top;     // Временный указатель на текущую вершину
-        top = top->next;      // Перемещаем вершину на следующий элемент
-        delete temp;          // Удаляем старую вершину
-        size--;
-    }
-
-    // Чтение всех элементов стека
-    void readStack() const {
-        Node* current = top;
-        cout << "Stack elements: ";
-        while (current != nullptr) {
-            cout << current->data << " ";
-            current = current->next;
-        }
-        cout << endl;
-    }
-
-    // Проверка, пуст ли стек
-    bool isEmpty() const {
-        return top == nullptr;
-    }
-
-    // Очистка стека (удаление всех элементов)
-    void clear() {
-        while (!isEmpty()) {
-            pop();
-        }
-    }
-
-    // Сохранение стека в файл
-    void saveToFile(const string& filename) {
-        ofstream outFile(filename);
-        if (outFile.is_open()) {
-            Node* current = top;
-            while (current != nullptr) {
-                outFile << current->data << endl;
-                current = current->next;
-            }
-            outFile.close();
-        } else {
-            cerr << "Unable to open file for writing!" << endl;
-        }
-    }
-
-    // Загрузка стека из файла
-    void loadFromFile(const string& filename) {
-        ifstream inFile(filename);
-        if (inFile.is_open()) {
-            int value;
-            clear();  // Сбрасываем текущий стек перед загрузкой
-            while (inFile >> value) {
-                push(value);
-            }
-            inFile.close();
-        } else {
-            cerr << "Unable to open file for reading!" << endl;
-        }
-    }
-
-    // Вывод всех элементов стека
-    void sprint() const {
-        Node* current = top;
-        cout << "Stack elements: ";
-        while (current != nullptr) {
-            cout << current->data << " ";
-            current = current->next;
-        }
-        cout << endl;
-    }
-
-private:
-    Node* top;  // Вершина стека (указатель на последний добавленный элемент)
-    int size;   // Текущий размер стека
-};
+using namespace std;
 
 // Обработка команд для стека
-void processCommand(Stack& stack, const string& command) {
-    string cmd;
-    int value;
-    istringstream iss(command);
-    iss >> cmd;
+template <typename StackType>
+bool executeCommand(StackType& stack, string_view command, Output& out) {
+    Tokenizer tokens(command);
+    string_view cmd = tokens.next();
+    int64_t value = 0;
 
     if (cmd == "SPUSH") {
-        iss >> value;
+        tokens.nextNumber(value);
         stack.push(value);
-        cout << "Pushed " << value << " to stack" << endl;
+        out.done("Pushed ", value, " to stack");
     } else if (cmd == "SPOP") {
-        stack.pop();
-        cout << "Popped top element from stack" << endl;
+        if (stack.pop(value)) {
+            out.value(value, "Popped top element from stack");
+        } else if (stack.length() > 0) {  // Сегмент --segmented не прочитался
+            out.error("Unable to read stack segment!");
+        } else {
+            out.missing("Stack is empty!\nPopped top element from stack");
+        }
     } else if (cmd == "SREAD") {
-        stack.readStack();
+        out.values(stack.length(), [&](ostream& stream) { stack.readStack(stream); },
+                   [&](auto visit) { stack.forEach(visit); });
     } else if (cmd == "SPRINT") {
-        stack.sprint();
+        out.values(stack.length(), [&](ostream& stream) { stack.sprint(stream); },
+                   [&](auto visit) { stack.forEach(visit); });
+    } else if (cmd == "STATS") {
+        out.report([&](ostream& stream) {
+            metrics.report(tokens, {{"elements", "Number of elements", static_cast<double>(stack.length())}}, {},
+                           stream);
+        });
     } else {
-        cout << "Unknown command: " << command << endl;
+        out.error("Unknown command: ", command);
+        return false;
+    }
+    return true;
+}
+
+// Выполнение команды с учетом в метриках
+template <typename StackType>
+bool processCommand(StackType& stack, string_view command, Output& out) {
+    return measureCommand(command, [&]() { return executeCommand(stack, command, out); });
+}
+
+// Загрузка, выполнение команд и сохранение для выбранной реализации
+template <typename StackType>
+int run(const string& filename, const string& modeFlag, const string& argument, OutputFormat format, SnapshotFormat snapshotFormat) {
+    StackType stack;
+    auto start = chrono::steady_clock::now();
+    stack.loadFromFile(filename);   // Загружаем данные из файла
+    metrics.recordLoad(Metrics::since(start));
+    auto handle = [&stack, format](string_view command, ostream& stream) {
+        Output out(stream, format);
+        return processCommand(stack, command, out);
+    };
+    auto save = [&stack, &filename, snapshotFormat]() {
+        auto start = chrono::steady_clock::now();
+        stack.saveToFile(filename, snapshotFormat);
+        metrics.recordSave(Metrics::since(start));
+    };
+    if (modeFlag == "--serve") {
+        return server::runServer(argument, handle, save, format);
+    }
+    if (modeFlag == "--batch" || modeFlag == "--replay") {
+        bool done = modeFlag == "--batch" ? batch::runBatch(argument, handle) : batch::runReplay(argument, handle);
+        if (done && modeFlag == "--batch") {  // Воспроизведение трассы не меняет файл данных
+            save();
+        }
+        return done ? 0 : 1;
     }
+    Output out(cout, format);
+    processCommand(stack, argument, out);  // Обрабатываем команду
+    save();                                // Сохраняем изменения в файл
+
+    return 0;
 }
 
 int main(int argc, char* argv[]) {
+    OutputFormat format = OutputFormat::Text;
+    if (!takeOutputFlags(argc, argv, format)) {
+        cerr << "Invalid output format!" << endl;
+        return 1;
+    }
+    SnapshotFormat snapshotFormat = SnapshotFormat::Text;
+    takeSnapshotFlags(argc, argv, snapshotFormat);  // --compress: файл данных в сжатом формате
+    bool segmented = takeSegmentedFlag(argc, argv);  // --segmented: файл данных из сегментов, см. segment.h
     if (argc != 5) {
-        cerr << "Usage: " << argv[0] << " --file filename --query 'COMMAND'" << endl;
+        cerr << "Usage: " << argv[0] << " --file filename --query 'COMMAND' | --batch file | --replay file | --serve address [--compress | --segmented] [--quiet | --output text|json|binary]" << endl;
         return 1;
     }
 
     string fileFlag = argv[1];
     string filename = argv[2];
-    string queryFlag = argv[3];
-    string query = argv[4];
+    string modeFlag = argv[3];
+    string argument = argv[4];  // Команда, файл с командами или адрес сервера
 
-    if (fileFlag != "--file" || queryFlag != "--query") {
+    if (fileFlag != "--file" || (modeFlag != "--query" && modeFlag != "--batch" && modeFlag != "--replay" && modeFlag != "--serve")) {
         cerr << "Invalid flags!" << endl;
         return 1;
     }
 
-    Stack stack;
-    stack.loadFromFile(filename);   // Загружаем данные из файла
-    processCommand(stack, query);   // Обрабатываем команду
-    stack.saveToFile(filename);     // Сохраняем изменения в файл
-
-    return 0;
+    // Реализация выбирается один раз: дальше все команды идут через run<StackType>
+    if (segmented) {
+        return run<SegmentedStack<int64_t>>(filename, modeFlag, argument, format, snapshotFormat);
+    }
+    return run<Stack<int64_t>>(filename, modeFlag, argument, format, snapshotFormat);
 }
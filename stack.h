@@ -0,0 +1,138 @@
+#ifndef STACK_H
+#define STACK_H
+
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <string_view>
+
+#include "snapshot.h"
+#include "traits.h"
+
+using namespace std;
+
+// Структура ноды для стека 
+template <typename T>
+struct StackNode {
+    T data;       // Данные ноды
+    StackNode<T>* next;     // Указатель на следующий элемент
+
+    StackNode(const T& value) : data(value), next(nullptr) {}
+};
+
+// Класс Stack для реализации стека элементов типа T
+template <typename T>
+class Stack {
+public:
+    Stack() : top(nullptr), size(0) {}
+
+    ~Stack() {
+        clear();  // Очистка памяти при удалении стека
+    }
+
+    // Добавление элемента на вершину стека
+    void push(const T& value) {
+        StackNode<T>* newNode = new StackNode<T>(value);
+        newNode->next = top;  // Устанавливаем указатель на текущую вершину
+        top = newNode;        // Вершина теперь указывает на новый элемент
+        size++;
+    }
+
+    // Снятие элемента с вершины без вывода; false, если стек пуст
+    bool pop(T& value) {
+        if (isEmpty()) {
+            return false;
+        }
+        StackNode<T>* temp = top;     // Временный указатель на текущую вершину
+        value = temp->data;
+        top = top->next;      // Перемещаем вершину на следующий элемент
+        delete temp;          // Удаляем старую вершину
+        size--;
+        return true;
+    }
+
+    // Удаление элемента с вершины стека
+    void pop(ostream& out = cout) {
+        T value;
+        if (!pop(value)) {
+            out << "Stack is empty!" << '\n';
+        }
+    }
+
+    // Элемент на вершине без удаления; false, если стек пуст
+    bool peek(T& value) const {
+        if (isEmpty()) {
+            return false;
+        }
+        value = top->data;
+        return true;
+    }
+
+    // Количество элементов
+    int length() const {
+        return size;
+    }
+
+    // Обход элементов от вершины вниз
+    template <typename F>
+    void forEach(F visit) const {
+        for (StackNode<T>* current = top; current != nullptr; current = current->next) {
+            visit(current->data);
+        }
+    }
+
+    // Чтение всех элементов стека
+    void readStack(ostream& out = cout) const {
+        StackNode<T>* current = top;
+        out << "Stack elements: ";
+        while (current != nullptr) {
+            out << printed<T>(current->data) << " ";
+            current = current->next;
+        }
+        out << '\n';
+    }
+
+    // Проверка, пуст ли стек
+    bool isEmpty() const {
+        return top == nullptr;
+    }
+
+    // Очистка стека (удаление всех элементов)
+    void clear() {
+        while (!isEmpty()) {
+            pop();
+        }
+    }
+
+    // Сохранение стека в файл от вершины (текстом или в сжатом формате, см. snapshot.h)
+    void saveToFile(const string& filename, SnapshotFormat format = SnapshotFormat::Text) {
+        if (!snapshot::save<T>(filename, format, [&](auto put) { forEach(put); })) {
+            cerr << "Unable to open file for writing!" << endl;
+        }
+    }
+
+    // Загрузка стека из файла любого формата
+    void loadFromFile(const string& filename) {
+        clear();  // Сбрасываем текущий стек перед загрузкой
+        if (!snapshot::load<T>(filename, [&](const T& value) { push(value); })) {
+            cerr << "Unable to open file for reading!" << endl;
+        }
+    }
+
+    // Вывод всех элементов стека
+    void sprint(ostream& out = cout) const {
+        StackNode<T>* current = top;
+        out << "Stack elements: ";
+        while (current != nullptr) {
+            out << printed<T>(current->data) << " ";
+            current = current->next;
+        }
+        out << '\n';
+    }
+
+private:
+    StackNode<T>* top;  // Вершина стека (указатель на последний добавленный элемент)
+    int size;   // Текущий размер стека
+};
+
+#endif
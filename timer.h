@@ -0,0 +1,165 @@
+#ifndef TIMER_H
+#define TIMER_H
+
+#include <chrono>
+#include <cstdint>
+
+// Текущее время в миллисекундах от эпохи Unix: сроки истечения ключей хранятся
+// в файле данных и должны пережить перезапуск
+inline int64_t wallClockMillis() {
+    return std::chrono::duration_cast<std::chrono::milliseconds>(
+               std::chrono::system_clock::now().time_since_epoch())
+        .count();
+}
+
+// Иерархическое колесо таймеров для истечения ключей. Entry - узел со встроенными
+// полями таймера:
+//   int64_t expiresAt  - срок в миллисекундах (wallClockMillis)
+//   Entry* timerNext   - следующий узел ячейки
+//   Entry** timerPrev  - указатель на ссылку, ведущую к узлу (nullptr, если таймера нет)
+// Уровень l состоит из 64 ячеек по 64^l мс; узел кладется на наименьший уровень,
+// блок которого содержит и срок, и текущее время колеса. При переходе через
+// границу уровня его ячейка переносится на уровни ниже, так что постановка и отмена -
+// O(1), а каждый узел переносится не больше levels - 1 раз.
+template <typename Entry>
+class TimerWheel {
+public:
+    static const int slotBits = 6;
+    static const int slotCount = 1 << slotBits;
+    static const int levels = 6;  // 64^6 мс - около двух лет; дальние сроки переносятся повторно
+
+    explicit TimerWheel(int64_t start = wallClockMillis()) : current(start), count(0), occupied() {
+        for (int l = 0; l < levels; ++l) {
+            for (int s = 0; s < slotCount; ++s) {
+                wheel[l][s] = nullptr;
+            }
+        }
+    }
+
+    TimerWheel(const TimerWheel&) = delete;
+    TimerWheel& operator=(const TimerWheel&) = delete;
+
+    // Постановка таймера узла по entry->expiresAt; узел не должен стоять в колесе
+    void schedule(Entry* entry) {
+        place(entry, entry->expiresAt > current ? entry->expiresAt : current + 1);  // Ячейка current уже обработана
+    }
+
+    // Снятие таймера; узел без таймера игнорируется
+    void cancel(Entry* entry) {
+        if (entry->timerPrev == nullptr) {
+            return;
+        }
+        Entry** link = entry->timerPrev;
+        *link = entry->timerNext;
+        if (entry->timerNext != nullptr) entry->timerNext->timerPrev = link;
+        entry->timerNext = nullptr;
+        entry->timerPrev = nullptr;
+        count--;
+        // Узел был первым в ячейке: если ячейка опустела, снимаем ее бит
+        Entry** first = &wheel[0][0];
+        if (link >= first && link < first + levels * slotCount && *link == nullptr) {
+            int index = static_cast<int>(link - first);
+            occupied[index / slotCount] &= ~(uint64_t(1) << (index % slotCount));
+        }
+    }
+
+    // Продвижение колеса до now: для каждого истекшего узла таймер снимается и
+    // вызывается expire(entry). Не больше limit вызовов; остаток - при следующем вызове.
+    // Возвращает число истекших узлов.
+    template <typename F>
+    int advance(int64_t now, int limit, F expire) {
+        int expired = 0;
+        while (current < now) {
+            if (count == 0) {
+                current = now;
+                break;
+            }
+            // Пока нижние уровни пусты, до следующей границы верхнего уровня ничего не истекает
+            int64_t next = current + 1;
+            for (int l = 0; l < levels - 1 && occupied[l] == 0; ++l) {
+                int shift = slotBits * (l + 1);
+                next = ((current >> shift) + 1) << shift;
+            }
+            if (next > now) {
+                current = now;
+                break;
+            }
+            current = next;
+            for (int l = levels - 1; l > 0; --l) {  // Сверху вниз: перенесенное может попасть в ячейку ниже
+                if ((next & ((int64_t(1) << (slotBits * l)) - 1)) == 0) {
+                    cascade(l, static_cast<int>((next >> (slotBits * l)) & (slotCount - 1)));
+                }
+            }
+            Entry*& head = wheel[0][next & (slotCount - 1)];
+            while (head != nullptr) {
+                if (expired == limit) {
+                    current = next - 1;  // Ячейка будет обработана заново
+                    return expired;
+                }
+                Entry* entry = head;
+                cancel(entry);
+                expire(entry);
+                expired++;
+            }
+        }
+        return expired;
+    }
+
+    // Число узлов с таймером
+    size_t size() const {
+        return count;
+    }
+
+    // Снятие всех таймеров без вызова expire
+    void clear() {
+        for (int l = 0; l < levels; ++l) {
+            for (int s = 0; s < slotCount; ++s) {
+                while (wheel[l][s] != nullptr) {
+                    cancel(wheel[l][s]);
+                }
+            }
+        }
+    }
+
+private:
+    // Постановка узла в ячейку по сроку target (не раньше current)
+    void place(Entry* entry, int64_t target) {
+        int level = 0;
+        while (level < levels - 1 && (target >> (slotBits * (level + 1))) != (current >> (slotBits * (level + 1)))) {
+            level++;
+        }
+        int shift = slotBits * level;
+        int slot;
+        if ((target >> shift) - (current >> shift) >= slotCount) {  // Дальше охвата колеса: в самую дальнюю ячейку
+            slot = static_cast<int>(((current >> shift) - 1) & (slotCount - 1));
+        } else {  // Верхний уровень кольцевой: срок может быть за границей его блока
+            slot = static_cast<int>((target >> shift) & (slotCount - 1));
+        }
+        Entry*& head = wheel[level][slot];
+        entry->timerNext = head;
+        entry->timerPrev = &head;
+        if (head != nullptr) head->timerPrev = &entry->timerNext;
+        head = entry;
+        occupied[level] |= uint64_t(1) << slot;
+        count++;
+    }
+
+    // Перенос ячейки уровня на уровни ниже относительно текущего времени; наступившие
+    // сроки попадают в ячейку current, которая обрабатывается сразу после переноса
+    void cascade(int level, int slot) {
+        Entry* entry = wheel[level][slot];
+        while (entry != nullptr) {
+            Entry* next = entry->timerNext;
+            cancel(entry);
+            place(entry, entry->expiresAt > current ? entry->expiresAt : current);
+            entry = next;
+        }
+    }
+
+    Entry* wheel[levels][slotCount];
+    int64_t current;            // Время, до которого колесо обработано
+    size_t count;               // Число узлов в колесе
+    uint64_t occupied[levels];  // Биты непустых ячеек каждого уровня
+};
+
+#endif
@@ -0,0 +1,166 @@
+#ifndef TRAITS_H
+#define TRAITS_H
+
+#include <charconv>
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <string_view>
+
+// Сериализация, разбор и хеширование типов элементов структур. Поддерживаются
+// int32_t, int64_t, double и string; для остальных типов общего определения нет,
+// так что ошибка обнаруживается при компиляции.
+//   View          - тип аргумента операций (string_view для строк, чтобы поиск не создавал string)
+//   write(out, v) - запись в файл данных (без пробелов, значения разделяются переводом строки)
+//   read(in, v)   - чтение из файла данных
+//   parse(t, v)   - разбор аргумента команды
+//   hash(v)       - хеш для HashTable
+//   heapBytes(v)  - память вне объекта T (буфер строки) для оценки памяти HashTable
+template <typename T>
+struct ValueTraits;
+
+// Перемешивание битов (финализатор MurmurHash3): последовательные идентификаторы
+// не должны попадать в соседние цепочки с общим делителем емкости
+inline uint64_t mixHash(uint64_t value) {
+    value ^= value >> 33;
+    value *= 0xff51afd7ed558ccdULL;
+    value ^= value >> 33;
+    value *= 0xc4ceb9fe1a85ec53ULL;
+    value ^= value >> 33;
+    return value;
+}
+
+template <typename T>
+struct IntegerTraits {
+    using View = T;
+
+    // to_chars вместо operator<<: без обращения к locale на каждое число
+    static void write(std::ostream& out, T value) {
+        char buffer[24];
+        auto result = std::to_chars(buffer, buffer + sizeof(buffer), value);
+        out.write(buffer, result.ptr - buffer);
+    }
+
+    static bool read(std::istream& in, T& value) {
+        return static_cast<bool>(in >> value);
+    }
+
+    static bool parse(std::string_view text, T& value) {
+        if (!text.empty() && text.front() == '+') {
+            text.remove_prefix(1);
+        }
+        auto result = std::from_chars(text.data(), text.data() + text.size(), value);
+        return result.ec == std::errc() && result.ptr == text.data() + text.size();
+    }
+
+    static uint64_t hash(T value) {
+        return mixHash(static_cast<uint64_t>(value));
+    }
+
+    static size_t heapBytes(T) {
+        return 0;
+    }
+};
+
+template <>
+struct ValueTraits<int32_t> : IntegerTraits<int32_t> {};
+
+template <>
+struct ValueTraits<int64_t> : IntegerTraits<int64_t> {};
+
+template <>
+struct ValueTraits<double> {
+    using View = double;
+
+    // Кратчайшая запись, из которой число читается обратно без потерь
+    static void write(std::ostream& out, double value) {
+        char buffer[32];
+        auto result = std::to_chars(buffer, buffer + sizeof(buffer), value);
+        out.write(buffer, result.ptr - buffer);
+    }
+
+    static bool read(std::istream& in, double& value) {
+        std::string text;
+        return static_cast<bool>(in >> text) && parse(text, value);
+    }
+
+    static bool parse(std::string_view text, double& value) {
+        if (!text.empty() && text.front() == '+') {
+            text.remove_prefix(1);
+        }
+        auto result = std::from_chars(text.data(), text.data() + text.size(), value);
+        return result.ec == std::errc() && result.ptr == text.data() + text.size();
+    }
+
+    static uint64_t hash(double value) {
+        if (value == 0) value = 0;  // +0.0 и -0.0 равны и должны попадать в одну цепочку
+        uint64_t bits;
+        static_assert(sizeof(bits) == sizeof(value), "double must be 64-bit");
+        std::memcpy(&bits, &value, sizeof(bits));
+        return mixHash(bits);
+    }
+
+    static size_t heapBytes(double) {
+        return 0;
+    }
+};
+
+template <>
+struct ValueTraits<std::string> {
+    using View = std::string_view;
+
+    static void write(std::ostream& out, std::string_view value) {
+        out << value;
+    }
+
+    static bool read(std::istream& in, std::string& value) {
+        return static_cast<bool>(in >> value);
+    }
+
+    static bool parse(std::string_view text, std::string& value) {
+        value.assign(text);
+        return !text.empty();
+    }
+
+    // Полиномиальный хеш по основанию 31 (прежняя хеш-функция HashTable)
+    static uint64_t hash(std::string_view value) {
+        unsigned int hash = 0;
+        for (char ch : value) {
+            hash = hash * 31 + static_cast<unsigned char>(ch);
+        }
+        return hash;
+    }
+
+    // Строки до 15 символов хранятся внутри объекта (SSO libstdc++)
+    static size_t heapBytes(std::string_view value) {
+        return value.size() > 15 ? value.size() + 1 : 0;
+    }
+};
+
+// Вывод значения в формате файла данных: out << printed<T>(value)
+template <typename T>
+struct Printed {
+    typename ValueTraits<T>::View value;
+};
+
+template <typename T>
+Printed<T> printed(typename ValueTraits<T>::View value) {
+    return {value};
+}
+
+template <typename T>
+std::ostream& operator<<(std::ostream& out, Printed<T> item) {
+    ValueTraits<T>::write(out, item.value);
+    return out;
+}
+
+// Хеш по умолчанию для HashTable<K, V, Hash>
+template <typename K>
+struct KeyHash {
+    uint64_t operator()(typename ValueTraits<K>::View key) const {
+        return ValueTraits<K>::hash(key);
+    }
+};
+
+#endif